@@ -23,6 +23,7 @@
 #include "Core/Context.h"
 #include "Memory/Pointers.h"
 #include "Engine/Engine.h"
+#include "Test/Tests.h"
 
 static Eris::SharedPtr<Eris::Context> context;
 
@@ -34,6 +35,11 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR pCmdLine, int nC
 
     context = new Eris::Context();
 
+    // "-test [filter]" runs the stress tests and benchmarks instead of the engine
+    std::string command_line{ pCmdLine };
+    if (command_line.compare(0, 5, "-test") == 0)
+        return Eris::runTests(context.get(), command_line.size() > 6 ? command_line.substr(6) : std::string{});
+
     Eris::Engine* app = new Eris::Engine(context.get());
     app->initialize();
 
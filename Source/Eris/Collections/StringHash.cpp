@@ -22,81 +22,92 @@
 
 #include "StringHash.h"
 
+#include "Core/Log.h"
+#include "Thread/SpinLock.h"
+
 namespace Eris 
 {
-    const StringHash StringHash::ZERO;
-
-    StringHash::StringHash() :
-        m_value(0)
+#ifdef ERIS_STRING_HASH_REGISTRY
+    namespace
     {
+        struct Registry
+        {
+            SpinLock lock;
+            std::unordered_map<glm::u32, std::string> strings;
+        };
+
+        Registry& getRegistry()
+        {
+            static Registry s_registry;
+            return s_registry;
+        }
     }
+#endif
 
-    StringHash::StringHash(const std::string& value)
+    const StringHash StringHash::ZERO;
+
+    glm::u32 calculateRuntimeStringHash(const char* value)
     {
-        std::hash<std::string> hasher;
-        m_value = hasher(value);
+        glm::u32 hash = STRING_HASH_OFFSET;
+        for (; *value; ++value)
+            hash = (hash ^ static_cast<glm::u8>(*value)) * STRING_HASH_PRIME;
+        return hash;
     }
 
-    StringHash::StringHash(const char* value)
+    glm::u32 calculateRuntimeStringHash(const std::string& value)
     {
-        std::hash<const char*> hasher;
-        m_value = hasher(value);
+        return calculateRuntimeStringHash(value.c_str());
     }
 
-    StringHash::StringHash(const StringHash& rhs)
+    StringHash::StringHash(const std::string& value) :
+        m_value(calculateRuntimeStringHash(value))
     {
-        m_value = rhs.m_value;
     }
 
     void StringHash::operator=(const std::string& value)
     {
-        std::hash<std::string> hasher;
-        m_value = hasher(value);
+        m_value = calculateRuntimeStringHash(value);
     }
 
     void StringHash::operator=(const char* value)
     {
-        std::hash<const char*> hasher;
-        m_value = hasher(value);
-    }
-
-    void StringHash::operator=(const StringHash& rhs)
-    {
-        m_value = rhs.m_value;
-    }
-
-    bool StringHash::operator==(const StringHash& rhs) const
-    {
-        return m_value == rhs.m_value;
-    }
-
-    bool StringHash::operator != (const StringHash& rhs) const
-    {
-        return m_value != rhs.m_value;
-    }
-
-    bool StringHash::operator<(const StringHash& rhs) const
-    {
-        return m_value < rhs.m_value;
-    }
-
-    bool StringHash::operator>(const StringHash& rhs) const
-    {
-        return m_value > rhs.m_value;
-    }
-
-    bool StringHash::operator<=(const StringHash& rhs) const
-    {
-        return m_value <= rhs.m_value;
+        m_value = calculateRuntimeStringHash(value);
     }
 
-    bool StringHash::operator>=(const StringHash& rhs) const
+    StringHash StringHash::registerString(const char* value)
     {
-        return m_value >= rhs.m_value;
+        StringHash hash(value);
+
+#ifdef ERIS_STRING_HASH_REGISTRY
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        auto find = registry.strings.find(hash.m_value);
+        if (find == registry.strings.end())
+            registry.strings[hash.m_value] = value;
+        else if (find->second != value)
+        {
+            Log::errorf("StringHash collision between %s and %s", find->second.c_str(), value);
+            ERIS_ASSERT(false);
+        }
+#endif
+
+        return hash;
     }
 
-    std::size_t StringHash::operator()() const
+    const char* StringHash::getString(const StringHash& hash)
     {
-        return m_value;
+#ifdef ERIS_STRING_HASH_REGISTRY
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        auto find = registry.strings.find(hash.m_value);
+        if (find != registry.strings.end())
+            return find->second.c_str();
+#else
+        (void) hash;
+#endif
+
+        return nullptr;
     }
 }
\ No newline at end of file
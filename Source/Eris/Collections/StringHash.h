@@ -22,36 +22,83 @@
 
 #pragma once
 
+#include <type_traits>
+
 namespace Eris
 {
+    static const glm::u32 STRING_HASH_OFFSET = 2166136261u;
+    static const glm::u32 STRING_HASH_PRIME = 16777619u;
+
+    /// 32 bit FNV-1a of the characters, evaluated by the compiler for literals where constexpr is available. Recurses
+    /// once per character, so only literals may use it.
+    ERIS_CONSTEXPR glm::u32 calculateStringHash(const char* value, glm::u32 hash = STRING_HASH_OFFSET)
+    {
+        return *value ? calculateStringHash(value + 1, (hash ^ static_cast<glm::u8>(*value)) * STRING_HASH_PRIME) : hash;
+    }
+
+    /// The same hash with a loop, for strings only known at runtime.
+    glm::u32 calculateRuntimeStringHash(const char* value);
+    glm::u32 calculateRuntimeStringHash(const std::string& value);
+
     class StringHash
     {
     public:
-        StringHash();
+        ERIS_CONSTEXPR StringHash() :
+            m_value(0)
+        {
+        }
+
+        template<std::size_t N>
+        ERIS_CONSTEXPR StringHash(const char (&value)[N]) :
+            m_value(calculateStringHash(value))
+        {
+        }
+
+        /// A template so literals still prefer the array constructor, pointers hash at runtime.
+        template<typename T, typename = typename std::enable_if<std::is_same<T, const char*>::value || std::is_same<T, char*>::value>::type>
+        StringHash(T value) :
+            m_value(calculateRuntimeStringHash(value))
+        {
+        }
+
         StringHash(const std::string& value);
-        StringHash(const char* value);
-        StringHash(const StringHash& rhs);
 
         void operator = (const std::string& value);
         void operator = (const char* value);
-        void operator = (const StringHash& rhs);
 
-        bool operator == (const StringHash& rhs) const;
-        bool operator != (const StringHash& rhs) const;
-        bool operator < (const StringHash& rhs) const;
-        bool operator > (const StringHash& rhs) const;
-        bool operator <= (const StringHash& rhs) const;
-        bool operator >= (const StringHash& rhs) const;
+        bool operator == (const StringHash& rhs) const { return m_value == rhs.m_value; }
+        bool operator != (const StringHash& rhs) const { return m_value != rhs.m_value; }
+        bool operator < (const StringHash& rhs) const { return m_value < rhs.m_value; }
+        bool operator > (const StringHash& rhs) const { return m_value > rhs.m_value; }
+        bool operator <= (const StringHash& rhs) const { return m_value <= rhs.m_value; }
+        bool operator >= (const StringHash& rhs) const { return m_value >= rhs.m_value; }
 
-        std::size_t operator()() const;
+        std::size_t operator()() const { return m_value; }
+
+        glm::u32 getValue() const { return m_value; }
+
+        /// Hash the value and, with ERIS_STRING_HASH_REGISTRY, remember it for reverse lookup and report collisions.
+        static StringHash registerString(const char* value);
+        /// The registered string for the hash, nullptr if unknown or the registry is compiled out.
+        static const char* getString(const StringHash& hash);
 
         static const StringHash ZERO;
 
     private:
-        std::size_t m_value;
+        glm::u32 m_value;
     };
 }
 
+#ifdef _DEBUG
+#define ERIS_STRING_HASH_REGISTRY
+#endif
+
+#ifdef ERIS_STRING_HASH_REGISTRY
+#define STRING_HASH(value) Eris::StringHash::registerString(value)
+#else
+#define STRING_HASH(value) Eris::StringHash(value)
+#endif
+
 namespace std
 {
     template<>
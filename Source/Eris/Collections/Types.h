@@ -33,6 +33,12 @@
 
 #include <boost/variant.hpp>
 
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define ERIS_CONSTEXPR inline
+#else
+#define ERIS_CONSTEXPR constexpr
+#endif
+
 namespace Eris
 {
     static const std::string StringEmpty = std::string();
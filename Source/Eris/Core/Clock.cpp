@@ -22,6 +22,8 @@
 
 #include "Clock.h"
 #include "Events.h"
+#include "FrameStats.h"
+#include "Profiler.h"
 
 #include "Collections/Functions.h"
 
@@ -44,6 +46,8 @@ namespace Eris
         m_frame_number++;
         m_time_step = time_step;
 
+        m_context->getModule<Profiler>()->beginFrame(m_frame_number);
+
         BeginFrameEvent* event = m_context->getFrameAllocator().newInstance<BeginFrameEvent>();
         event->frame_number = m_frame_number;
         event->time_step = m_time_step;
@@ -54,6 +58,10 @@ namespace Eris
     void Clock::endFrame()
     {
         sendEvent(EndFrameEvent::getTypeStatic());
+
+        // After the handlers so gauges they set are sampled with the frame they describe.
+        m_context->getModule<Profiler>()->endFrame(m_frame_number);
+        m_context->getModule<FrameStats>()->endFrame();
     }
 
     glm::f64 Clock::getElapsedTime() const
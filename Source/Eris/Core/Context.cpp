@@ -25,6 +25,7 @@
 
 // Include all module definitions
 #include "Clock.h"
+#include "FrameStats.h"
 #include "Log.h"
 #include "Profiler.h"
 #include "Engine/Engine.h"
@@ -35,65 +36,53 @@
 #include "Input/Input.h"
 #include "IO/FileSystem.h"
 #include "Resource/ResourceCache.h"
+#include "Thread/JobSystem.h"
 
 namespace Eris
 {
     Context::Context() :
-        m_frame_allocator(0, 4096),
+        m_frame_allocator(new FrameMemoryPool(FRAME_ALLOCATOR_SIZE, FRAME_ALLOCATOR_FRAMES)),
+        m_posted_count(0),
+        m_coalesce_from(0),
         m_clock(nullptr),
         m_engine(nullptr),
         m_graphics(nullptr),
         m_input(nullptr),
+        m_jobs(nullptr),
         m_locale(nullptr),
         m_log(nullptr),
         m_fs(nullptr),
+        m_frame_stats(nullptr),
         m_cache(nullptr),
         m_settings(nullptr),
         m_renderer(nullptr),
         m_profiler(nullptr)
     {
+        m_frame_allocator->setName("Frame");
     }
 
-    void Context::addEventReciever(Object* reciever, const StringHash& event_type, Object* sender)
+    void Context::addEventReciever(Object* reciever, EventHandler* handler)
     {
-        if (sender)
-            m_specific_recievers[sender][event_type].insert(reciever);
+        if (handler->getSender())
+            m_specific_recievers[handler->getSender()][handler->getEventType()].add(reciever, handler);
         else
-            m_recievers[event_type].insert(reciever);
+            m_recievers[handler->getEventType()].add(reciever, handler);
     }
 
     void Context::removeEventSender(Object* sender)
     {
-        auto iter = m_specific_recievers.find(sender);
-        if (iter != m_specific_recievers.end())
-        {
-            for (auto i : iter->second)
-            {
-                for (auto j : i.second)
-                    (*j).removeEventSender(sender);
-            }
-            m_specific_recievers.erase(iter);
-        }
-    }
-
-    void Context::removeEventReciever(Object* reciever, const StringHash& event_type, Object* sender)
-    {
-        std::unordered_set<Object*>* group = _getEventRecievers(event_type, sender);
-        if (group)
-            group->erase(reciever);
-    }
-
-    const std::unordered_set<Object*>* Context::getEventRecievers(const StringHash& event_type, Object* sender)
-    {
-        return _getEventRecievers(event_type, sender);
+        // The sender has already unlinked every handler subscribed to it, only the empty lists remain.
+        m_specific_recievers.erase(sender);
     }
 
-    void Context::resetFrameAllocator()
+    void Context::removeEventReciever(EventHandler* handler)
     {
-        m_frame_allocator.getMemoryPool().reset();
+        EventSubscriberList* list = handler->getSubscriberList();
+        if (list)
+            list->remove(handler);
     }
 
-    std::unordered_set<Object*>* Context::_getEventRecievers(const StringHash& event_type, Object* sender /*= nullptr*/)
+    EventSubscriberList* Context::getEventRecievers(const StringHash& event_type, Object* sender /*= nullptr*/)
     {
         if (sender)
         {
@@ -101,7 +90,7 @@ namespace Eris
             if (sm != m_specific_recievers.end())
             {
                 auto iter = sm->second.find(event_type);
-                if (iter != m_recievers.end())
+                if (iter != sm->second.end())
                     return &iter->second;
             }
         }
@@ -114,4 +103,104 @@ namespace Eris
 
         return nullptr;
     }
+
+    void Context::postEvent(Object* sender, const StringHash& event_type, Event* event)
+    {
+        ERIS_ASSERT(sender);
+
+        PostedEvent* posted = m_frame_allocator->newInstance<PostedEvent>(sender, event_type, event);
+        if (!posted)
+        {
+            Log::error("Failed to post event, frame allocator exhausted");
+            return;
+        }
+
+        // Counted before linking so a dispatch never takes more events than were posted ahead of it.
+        m_posted_count++;
+        m_posted_events.push(posted);
+    }
+
+    void Context::dispatchPostedEvents()
+    {
+        // Only deliver what was posted before the dispatch started, events posted by handlers wait for the next frame.
+        glm::u32 pending = m_posted_count.exchange(0);
+        while (pending)
+        {
+            PostedEvent* posted = m_posted_events.pop();
+            if (!posted)
+            {
+                // A producer has not finished linking its event yet.
+                m_posted_count += pending;
+                break;
+            }
+            pending--;
+
+            SharedPtr<Object> sender = posted->sender.lock();
+            if (sender)
+                sender->sendEvent(posted->event_type, posted->event);
+        }
+    }
+
+    void Context::bufferEvent(Object* sender, const StringHash& event_type, Event* event)
+    {
+        ERIS_ASSERT(sender);
+
+        EventCoalescing policy = getEventCoalescing(event_type);
+        if (policy == EventCoalescing::KEEP_ALL)
+        {
+            // Nothing buffered before this event may be merged with a later one, or their order would change.
+            m_buffered_events.push_back({ WeakPtr<Object>(sender), event_type, event });
+            m_coalesce_from = m_buffered_events.size();
+            return;
+        }
+
+        for (std::size_t i = m_buffered_events.size(); i > m_coalesce_from; i--)
+        {
+            BufferedEvent& pending = m_buffered_events[i - 1];
+            if (pending.event_type != event_type || pending.sender.get() != sender)
+                continue;
+
+            if (policy == EventCoalescing::ACCUMULATE && pending.event && event)
+                pending.event->coalesce(*event);
+            else
+                pending.event = event;
+            return;
+        }
+
+        m_buffered_events.push_back({ WeakPtr<Object>(sender), event_type, event });
+    }
+
+    void Context::dispatchBufferedEvents()
+    {
+        // Events buffered by handlers wait for the next dispatch, they live in the frame allocator for long enough.
+        m_dispatching_events.swap(m_buffered_events);
+        m_coalesce_from = 0;
+
+        for (auto& buffered : m_dispatching_events)
+        {
+            SharedPtr<Object> sender = buffered.sender.lock();
+            if (sender)
+                sender->sendEvent(buffered.event_type, buffered.event);
+        }
+        m_dispatching_events.clear();
+    }
+
+    void Context::setEventCoalescing(const StringHash& event_type, EventCoalescing policy)
+    {
+        if (policy == EventCoalescing::KEEP_ALL)
+            m_event_coalescing.erase(event_type);
+        else
+            m_event_coalescing[event_type] = policy;
+    }
+
+    EventCoalescing Context::getEventCoalescing(const StringHash& event_type) const
+    {
+        auto iter = m_event_coalescing.find(event_type);
+        return iter != m_event_coalescing.end() ? iter->second : EventCoalescing::KEEP_ALL;
+    }
+
+    void Context::advanceFrameAllocator()
+    {
+        m_frame_allocator->nextFrame();
+    }
 }
\ No newline at end of file
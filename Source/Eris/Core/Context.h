@@ -23,23 +23,26 @@
 #pragma once
 
 #include "Event.h"
+#include "EventHandler.h"
 
 #include "Collections/StringHash.h"
 #include "Memory/RefCounted.h"
 #include "Memory/Pointers.h"
 #include "Memory/Allocator.h"
+#include "Thread/MpscQueue.h"
 #include "Util/NonCopyable.h"
 
 #include <unordered_map>
-#include <unordered_set>
 
 namespace Eris
 {
     class Clock;
     class Engine;
     class FileSystem;
+    class FrameStats;
     class Graphics;
     class Input;
+    class JobSystem;
     class Locale;
     class Log;
     class Profiler;
@@ -47,6 +50,9 @@ namespace Eris
     class ResourceCache;
     class Settings;
 
+    static const std::size_t FRAME_ALLOCATOR_SIZE = 64 * 1024;
+    static const glm::u32 FRAME_ALLOCATOR_FRAMES = 3;
+
     class Context : public RefCounted, public NonCopyable
     {
         friend class Object;
@@ -57,27 +63,67 @@ namespace Eris
         template<typename T> void registerModule(T* module) {}
         template<typename T> T* getModule() { return nullptr; }
 
-        void addEventReciever(Object* reciever, const StringHash& event_type, Object* sender);
+        void addEventReciever(Object* reciever, EventHandler* handler);
         void removeEventSender(Object* sender);
-        void removeEventReciever(Object* reciever, const StringHash& event_type, Object* sender = nullptr);
-        const std::unordered_set<Object*>* getEventRecievers(const StringHash& event_type, Object* sender = nullptr);
+        void removeEventReciever(EventHandler* handler);
+        EventSubscriberList* getEventRecievers(const StringHash& event_type, Object* sender = nullptr);
+
+        /// Safe from any thread, the event is delivered by dispatchPostedEvents on the main thread.
+        void postEvent(Object* sender, const StringHash& event_type, Event* event);
+        void dispatchPostedEvents();
 
-        StackAllocator<glm::u8>& getFrameAllocator() { return m_frame_allocator; }
-        void resetFrameAllocator();
+        /// Main thread only, the event is delivered by dispatchBufferedEvents after being merged with a pending one
+        /// according to the coalescing policy of its type.
+        void bufferEvent(Object* sender, const StringHash& event_type, Event* event);
+        void dispatchBufferedEvents();
+        void setEventCoalescing(const StringHash& event_type, EventCoalescing policy);
+        EventCoalescing getEventCoalescing(const StringHash& event_type) const;
+
+        FrameMemoryPool& getFrameAllocator() { return *m_frame_allocator; }
+        void advanceFrameAllocator();
 
     private:
-        std::unordered_set<Object*>* _getEventRecievers(const StringHash& event_type, Object* sender = nullptr);
+        struct PostedEvent : public MpscNode
+        {
+            PostedEvent(Object* sender, const StringHash& event_type, Event* event) :
+                sender(sender),
+                event_type(event_type),
+                event(event)
+            {
+            }
+
+            WeakPtr<Object> sender;
+            StringHash event_type;
+            Event* event;
+        };
+
+        struct BufferedEvent
+        {
+            WeakPtr<Object> sender;
+            StringHash event_type;
+            Event* event;
+        };
+
+        std::unordered_map<StringHash, EventSubscriberList> m_recievers;
+        std::unordered_map<Object*, std::unordered_map<StringHash, EventSubscriberList>> m_specific_recievers;
+
+        SharedPtr<FrameMemoryPool> m_frame_allocator;
 
-        std::unordered_map<StringHash, std::unordered_set<Object*>> m_recievers;
-        std::unordered_map<Object*, std::unordered_map<StringHash, std::unordered_set<Object*>>> m_specific_recievers;
+        MpscQueue<PostedEvent> m_posted_events;
+        std::atomic<glm::u32> m_posted_count;
 
-        StackAllocator<glm::u8> m_frame_allocator;
+        std::vector<BufferedEvent> m_buffered_events;
+        std::vector<BufferedEvent> m_dispatching_events;
+        std::size_t m_coalesce_from;
+        std::unordered_map<StringHash, EventCoalescing> m_event_coalescing;
 
         SharedPtr<Clock> m_clock;
         SharedPtr<Engine> m_engine;
         SharedPtr<FileSystem> m_fs;
+        SharedPtr<FrameStats> m_frame_stats;
         SharedPtr<Graphics> m_graphics;
         SharedPtr<Input> m_input;
+        SharedPtr<JobSystem> m_jobs;
         SharedPtr<Locale> m_locale;
         SharedPtr<Log> m_log;
         SharedPtr<Profiler> m_profiler;
@@ -29,12 +29,23 @@ namespace Eris
 {
 #define EVENT(typeName) \
     virtual const StringHash& getType() const { return getTypeStatic(); } \
-    static const StringHash& getTypeStatic() { static const StringHash typeStatic(#typeName); return typeStatic; } \
+    static const StringHash& getTypeStatic() { static const StringHash typeStatic = STRING_HASH(#typeName); return typeStatic; } \
+
+    /// How Context::bufferEvent merges an event with a pending one of the same type from the same sender.
+    enum class EventCoalescing : glm::u8
+    {
+        KEEP_ALL,
+        LAST_WINS,
+        ACCUMULATE
+    };
 
     struct Event : Aligned<1>
     {
         virtual ~Event() { }
 
         virtual const StringHash& getType() const = 0;
+
+        /// Folds a newer event of the same type into this one, types buffered with EventCoalescing::ACCUMULATE must implement it.
+        virtual void coalesce(const Event& newer) { }
     };
 }
\ No newline at end of file
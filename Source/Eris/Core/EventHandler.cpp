@@ -24,17 +24,47 @@
 
 namespace Eris
 {
+    EventHandler::EventHandler(InvokeFunctionPtr invoke) :
+        m_invoke(invoke),
+        m_sender(0),
+        m_user_data(0),
+        m_list(nullptr),
+        m_index(0),
+        m_owner(nullptr),
+        m_prev(nullptr),
+        m_next(nullptr),
+        m_sender_prev(nullptr),
+        m_sender_next(nullptr)
+    {
+    }
+
     EventHandler::EventHandler(HandlerFunctionPtr function) :
+        m_invoke(&EventHandler::invokeFunction),
         m_sender(0),
         m_function(function),
-        m_user_data(0)
+        m_user_data(0),
+        m_list(nullptr),
+        m_index(0),
+        m_owner(nullptr),
+        m_prev(nullptr),
+        m_next(nullptr),
+        m_sender_prev(nullptr),
+        m_sender_next(nullptr)
     {
     }
 
     EventHandler::EventHandler(HandlerFunctionPtr function, void* user_data) :
+        m_invoke(&EventHandler::invokeFunction),
         m_sender(0),
         m_function(function),
-        m_user_data(user_data)
+        m_user_data(user_data),
+        m_list(nullptr),
+        m_index(0),
+        m_owner(nullptr),
+        m_prev(nullptr),
+        m_next(nullptr),
+        m_sender_prev(nullptr),
+        m_sender_next(nullptr)
     {
     }
 
@@ -53,9 +83,84 @@ namespace Eris
         m_event_type = event_type; 
     }
 
-    void EventHandler::invoke(const Event* event) 
+    void EventHandler::invokeFunction(EventHandler* handler, const Event* event)
     { 
-        m_function(m_event_type, event); 
+        handler->m_function(handler->m_event_type, event); 
+    }
+
+    EventSubscriberList::EventSubscriberList() :
+        m_dispatching(0),
+        m_dirty(false)
+    {
+    }
+
+    void EventSubscriberList::add(Object* reciever, EventHandler* handler)
+    {
+        ERIS_ASSERT(!handler->m_list);
+
+        handler->m_list = this;
+        handler->m_index = static_cast<glm::u32>(m_subscribers.size());
+
+        EventSubscriber subscriber = { reciever, handler };
+        m_subscribers.push_back(subscriber);
+    }
+
+    void EventSubscriberList::remove(EventHandler* handler)
+    {
+        ERIS_ASSERT(handler->m_list == this);
+        ERIS_ASSERT(m_subscribers[handler->m_index].handler == handler);
+
+        glm::u32 index = handler->m_index;
+        handler->m_list = nullptr;
+
+        if (m_dispatching)
+        {
+            m_subscribers[index].reciever = nullptr;
+            m_subscribers[index].handler = nullptr;
+            m_dirty = true;
+            return;
+        }
+
+        if (index + 1 != m_subscribers.size())
+        {
+            m_subscribers[index] = m_subscribers.back();
+            m_subscribers[index].handler->m_index = index;
+        }
+        m_subscribers.pop_back();
+    }
+
+    EventHandler* EventSubscriberList::find(const Object* reciever) const
+    {
+        for (const EventSubscriber& subscriber : m_subscribers)
+        {
+            if (subscriber.reciever == reciever)
+                return subscriber.handler;
+        }
+        return nullptr;
+    }
+
+    void EventSubscriberList::endDispatch()
+    {
+        ERIS_ASSERT(m_dispatching > 0);
+
+        if (--m_dispatching == 0 && m_dirty)
+            compact();
+    }
+
+    void EventSubscriberList::compact()
+    {
+        glm::u32 count = 0;
+        for (const EventSubscriber& subscriber : m_subscribers)
+        {
+            if (subscriber.handler)
+            {
+                subscriber.handler->m_index = count;
+                m_subscribers[count++] = subscriber;
+            }
+        }
+
+        m_subscribers.resize(count);
+        m_dirty = false;
     }
 
 }
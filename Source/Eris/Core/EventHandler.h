@@ -26,14 +26,25 @@
 #include "Collections/StringHash.h"
 #include "Memory/RefCounted.h"
 
+#include <vector>
+
 namespace Eris
 {
     class Object;
+    class EventSubscriberList;
 
     class EventHandler : public RefCounted
     {
+        friend class EventSubscriberList;
+        friend class Object;
+
         using HandlerFunctionPtr = std::function < void(const StringHash&, const Event*) > ;
 
+    protected:
+        using InvokeFunctionPtr = void(*)(EventHandler* handler, const Event* event);
+
+        EventHandler(InvokeFunctionPtr invoke);
+
     public:
         EventHandler(HandlerFunctionPtr function);
         EventHandler(HandlerFunctionPtr function, void* user_data);
@@ -45,14 +56,84 @@ namespace Eris
 
         Object* getSender() const { return m_sender; }
         const StringHash& getEventType() const { return m_event_type; }
+        EventSubscriberList* getSubscriberList() const { return m_list; }
 
-        void invoke(const Event* event);
+        void invoke(const Event* event) { m_invoke(this, event); }
 
     private:
+        static void invokeFunction(EventHandler* handler, const Event* event);
+
+        InvokeFunctionPtr m_invoke;
         Object* m_sender;
         StringHash m_event_type;
         HandlerFunctionPtr m_function;
         void* m_user_data;
+        EventSubscriberList* m_list;
+        glm::u32 m_index;
+
+        // Intrusive links into the subscribing object's handlers and the sender's specific handlers, so tearing
+        // down either side never searches.
+        Object* m_owner;
+        EventHandler* m_prev;
+        EventHandler* m_next;
+        EventHandler* m_sender_prev;
+        EventHandler* m_sender_next;
+    };
+
+    /// Calls a member function with the concrete event, without going through std::function. The function is a
+    /// template argument, so the one indirect call into the thunk is followed by a direct call. A null payload is
+    /// passed as a value initialised event.
+    template<typename T, typename E, void (T::*Function)(const E&)>
+    class TypedEventHandler : public EventHandler
+    {
+    public:
+        TypedEventHandler(T* reciever) :
+            EventHandler(&TypedEventHandler::invokeTyped),
+            m_reciever(reciever)
+        {
+        }
+
+    private:
+        static void invokeTyped(EventHandler* handler, const Event* event)
+        {
+            static const E s_empty = E();
+
+            (static_cast<TypedEventHandler*>(handler)->m_reciever->*Function)(event ? *static_cast<const E*>(event) : s_empty);
+        }
+
+        T* m_reciever;
+    };
+
+    struct EventSubscriber
+    {
+        Object* reciever;
+        EventHandler* handler;
+    };
+
+    /// Contiguous subscribers to one event type. Removing during a dispatch leaves a hole, which is compacted once the outermost dispatch ends.
+    class EventSubscriberList
+    {
+    public:
+        EventSubscriberList();
+
+        void add(Object* reciever, EventHandler* handler);
+        void remove(EventHandler* handler);
+        /// The reciever's handler in this list, searches it linearly.
+        EventHandler* find(const Object* reciever) const;
+        bool contains(Object* reciever) const { return find(reciever) != nullptr; }
+
+        void beginDispatch() { m_dispatching++; }
+        void endDispatch();
+
+        std::size_t size() const { return m_subscribers.size(); }
+        const EventSubscriber& operator [] (std::size_t index) const { return m_subscribers[index]; }
+
+    private:
+        void compact();
+
+        std::vector<EventSubscriber> m_subscribers;
+        glm::u32 m_dispatching;
+        bool m_dirty;
     };
 
 #define HANDLER(className, function) (new Eris::EventHandler(std::bind(&className::function, this, std::placeholders::_1, std::placeholders::_2)))
@@ -0,0 +1,196 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "FrameStats.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Eris
+{
+    FrameStats::FrameStats(Context* context) :
+        Object(context),
+        m_frame_start(0)
+    {
+        m_frame_time.name = "Frame";
+        m_frame_time.count = 0;
+        m_frame_time.frame_ticks = 0;
+
+        // Reserved up front so frames never allocate once every thread and scope has been seen.
+        m_scopes.reserve(FRAME_STATS_MAX_SCOPES);
+        m_threads.reserve(PROFILER_MAX_THREADS);
+        m_events.reserve(PROFILER_BUFFER_SIZE);
+    }
+
+    void FrameStats::endFrame()
+    {
+        glm::u64 now = __rdtsc();
+        glm::f64 ticks_per_ms = Profiler::getTicksPerSecond() / 1000.0;
+
+        if (m_frame_start)
+            addSample(m_frame_time, (now - m_frame_start) / ticks_per_ms);
+
+        m_frame_start = now;
+
+        while (m_threads.size() < Profiler::getThreadBufferCount())
+            m_threads.push_back(ThreadState{ 0, 0, 0, nullptr });
+
+        for (glm::u32 i = 0; i < m_threads.size(); i++)
+        {
+            ProfilerThreadBuffer* buffer = Profiler::getThreadBuffer(i);
+            if (!buffer)
+                continue;
+
+            ThreadState& thread = m_threads[i];
+            glm::u64 position = thread.position;
+
+            m_events.clear();
+            thread.position = buffer->read(m_events, position);
+
+            // Events were lost, the open scopes can no longer be matched.
+            if (thread.position - position != m_events.size())
+                thread.depth = 0;
+
+            for (const ProfilerEvent& event : m_events)
+            {
+                if (event.type == ProfilerEventType::BEGIN)
+                {
+                    if (!thread.depth++)
+                    {
+                        thread.begin = event.time;
+                        thread.name = event.zone->name;
+                    }
+                }
+                else if (event.type == ProfilerEventType::END && thread.depth)
+                {
+                    if (!--thread.depth)
+                        addScopeTime(thread.name, event.time - thread.begin);
+                }
+            }
+        }
+
+        for (History& scope : m_scopes)
+        {
+            if (scope.frame_ticks)
+            {
+                addSample(scope, scope.frame_ticks / ticks_per_ms);
+                scope.frame_ticks = 0;
+            }
+        }
+    }
+
+    FrameTimeStats FrameStats::getFrameTime() const
+    {
+        return computeStats(m_frame_time);
+    }
+
+    FrameTimeStats FrameStats::getScopeTime(const std::string& name) const
+    {
+        for (const History& scope : m_scopes)
+        {
+            if (name == scope.name)
+                return computeStats(scope);
+        }
+
+        FrameTimeStats stats = {};
+        stats.name = name;
+        return stats;
+    }
+
+    std::vector<FrameTimeStats> FrameStats::getScopeTimes() const
+    {
+        std::vector<FrameTimeStats> out;
+        for (const History& scope : m_scopes)
+            out.push_back(computeStats(scope));
+
+        return out;
+    }
+
+    void FrameStats::logSummary() const
+    {
+        std::vector<FrameTimeStats> all = getScopeTimes();
+        all.insert(all.begin(), getFrameTime());
+
+        for (auto& stats : all)
+        {
+            Log::rawf("\tTime %s: %u frames, min %.3f ms, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms", stats.name.c_str(),
+                stats.samples, stats.min, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+        }
+    }
+
+    void FrameStats::addScopeTime(const char* name, glm::u64 ticks)
+    {
+        // Keyed by name rather than zone so the same scope name at several sites is reported once.
+        for (History& scope : m_scopes)
+        {
+            if (scope.name == name || !strcmp(scope.name, name))
+            {
+                scope.frame_ticks += ticks;
+                return;
+            }
+        }
+
+        if (m_scopes.size() >= FRAME_STATS_MAX_SCOPES)
+            return;
+
+        m_scopes.push_back(History());
+        History& scope = m_scopes.back();
+        scope.name = name;
+        scope.count = 0;
+        scope.frame_ticks = ticks;
+    }
+
+    void FrameStats::addSample(History& history, glm::f64 value)
+    {
+        history.values[history.count++ % FRAME_STATS_HISTORY] = static_cast<glm::f32>(value);
+    }
+
+    FrameTimeStats FrameStats::computeStats(const History& history) const
+    {
+        FrameTimeStats stats = {};
+        stats.name = history.name;
+        stats.samples = std::min(history.count, FRAME_STATS_HISTORY);
+
+        if (!stats.samples)
+            return stats;
+
+        std::vector<glm::f32> sorted(history.values, history.values + stats.samples);
+        std::sort(sorted.begin(), sorted.end());
+
+        glm::f64 sum = 0.0;
+        for (glm::f32 value : sorted)
+            sum += value;
+
+        // Nearest rank, so p99 of a short run is its slowest frame rather than an interpolation.
+        auto percentile = [&](glm::f64 p) { return sorted[static_cast<std::size_t>(std::ceil(p * stats.samples)) - 1]; };
+
+        stats.min = sorted.front();
+        stats.mean = sum / stats.samples;
+        stats.p50 = percentile(0.50);
+        stats.p95 = percentile(0.95);
+        stats.p99 = percentile(0.99);
+        stats.max = sorted.back();
+        return stats;
+    }
+}
\ No newline at end of file
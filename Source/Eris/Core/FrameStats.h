@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Context.h"
+#include "Object.h"
+#include "Profiler.h"
+
+#include <string>
+#include <vector>
+
+namespace Eris
+{
+    /// Frames the rolling statistics cover.
+    static const glm::u32 FRAME_STATS_HISTORY = 1024;
+    static const glm::u32 FRAME_STATS_MAX_SCOPES = 64;
+
+    /// Times are in milliseconds over the last samples frames.
+    struct FrameTimeStats
+    {
+        std::string name;
+        glm::u32 samples;
+        glm::f64 min;
+        glm::f64 mean;
+        glm::f64 p50;
+        glm::f64 p95;
+        glm::f64 p99;
+        glm::f64 max;
+    };
+
+    /// Rolling frame time statistics, along with the time spent in every profiled scope that was outermost on its
+    /// thread. Scopes are timed from the profiler buffers, so they are only available when profiling is compiled in.
+    class FrameStats : public Object
+    {
+    public:
+        FrameStats(Context* context);
+
+        /// Called by the Clock at the end of every frame on the main thread.
+        void endFrame();
+
+        FrameTimeStats getFrameTime() const;
+
+        /// A scope is sampled in the frames it ran in, summing every run of the frame. Scopes that never ran have no
+        /// samples.
+        FrameTimeStats getScopeTime(const std::string& name) const;
+        std::vector<FrameTimeStats> getScopeTimes() const;
+
+        void logSummary() const;
+
+    private:
+        struct History
+        {
+            const char* name;
+            glm::f32 values[FRAME_STATS_HISTORY];
+            glm::u32 count;
+            glm::u64 frame_ticks;
+        };
+
+        struct ThreadState
+        {
+            glm::u64 position;
+            glm::u32 depth;
+            glm::u64 begin;
+            const char* name;
+        };
+
+        void addScopeTime(const char* name, glm::u64 ticks);
+        void addSample(History& history, glm::f64 value);
+        FrameTimeStats computeStats(const History& history) const;
+
+        History m_frame_time;
+        std::vector<History> m_scopes;
+        std::vector<ThreadState> m_threads;
+        std::vector<ProfilerEvent> m_events;
+        glm::u64 m_frame_start;
+    };
+
+    template<> inline void Context::registerModule(FrameStats* module)
+    {
+        m_frame_stats = SharedPtr<FrameStats>(module);
+    }
+
+    template<> inline FrameStats* Context::getModule()
+    {
+        ERIS_ASSERT(m_frame_stats);
+        return m_frame_stats.get();
+    }
+}
\ No newline at end of file
@@ -35,6 +35,8 @@ namespace Eris
         m_level(Level::INFO),
         m_timestamp(true)
     {
+        m_lock.setName("Log");
+
         log = this;
         glfwSetErrorCallback(&Log::errorCallback);
     }
@@ -118,7 +120,7 @@ namespace Eris
     {
         if (level >= m_level)
         {
-            std::lock_guard<SpinLock> lock(m_lock);
+            std::lock_guard<AdaptiveLock> lock(m_lock);
 
             if (m_timestamp)
                 m_handle << "[" << m_context->getModule<Clock>()->getTimestamp().c_str() << "] ";
@@ -26,7 +26,7 @@
 #include "Object.h"
 
 #include "IO/FileSystem.h"
-#include "Thread/SpinLock.h"
+#include "Thread/AdaptiveLock.h"
 #include "Collections/Functions.h"
 
 #include <utility>
@@ -100,7 +100,7 @@ namespace Eris
         std::ofstream m_handle;
         bool m_timestamp;
         Level m_level;
-        SpinLock m_lock;
+        AdaptiveLock m_lock;
     };
 
     template<> inline void Context::registerModule(Log* module)
@@ -23,21 +23,42 @@
 #include "Context.h"
 #include "Object.h"
 #include "Event.h"
+#include "Profiler.h"
 
-#include <unordered_map>
-#include <unordered_set>
+#include <thread>
 
 namespace Eris
 {
+    static ProfilerCounter s_events_dispatched("EventsDispatched");
+
+    // sendEvent runs on the main thread. Every nesting depth stamps its own slot, deeper ones search the list instead.
+    static glm::u32 s_dispatch_stamp = 0;
+    static glm::u32 s_dispatch_depth = 0;
+
+#ifdef _DEBUG
+    // Static initialisation runs on the main thread, which is also job worker 0 while a frame graph phase runs.
+    static const std::thread::id s_main_thread = std::this_thread::get_id();
+#endif
+
     Object::Object(Context* context) :
-        m_context(context)
+        m_context(context),
+        m_handlers(nullptr),
+        m_sender_handlers(nullptr),
+        m_has_sender_handlers(false)
     {
+        for (glm::u32& stamp : m_dispatch_stamps)
+            stamp = 0;
     }
 
     Object::~Object()
     {
         unsubscribeFromEvents();
-        m_context->removeEventSender(this);
+
+        while (m_sender_handlers)
+            m_sender_handlers->m_owner->removeEventHandler(m_sender_handlers);
+
+        if (m_has_sender_handlers)
+            m_context->removeEventSender(this);
     }
 
     void Object::subscribeToEvent(const StringHash& event_type, EventHandler* handler, Object* sender /*= nullptr*/)
@@ -45,38 +66,54 @@ namespace Eris
         if (!handler)
             return;
 
+        ERIS_ASSERT(std::this_thread::get_id() == s_main_thread);
+        ERIS_ASSERT(!findEventHandler(event_type, sender));
+
         handler->setEventType(event_type);
         handler->setSender(sender);
 
-        auto old = m_handlers.end();
-        if (!sender)
-            old = findEventHandler(event_type);
-        else
-            old = findEventHandler(event_type, sender);
+        handler->increment();
+        handler->m_owner = this;
+        handler->m_prev = nullptr;
+        handler->m_next = m_handlers;
+        if (m_handlers)
+            m_handlers->m_prev = handler;
+        m_handlers = handler;
+
+        if (sender)
+        {
+            handler->m_sender_prev = nullptr;
+            handler->m_sender_next = sender->m_sender_handlers;
+            if (sender->m_sender_handlers)
+                sender->m_sender_handlers->m_sender_prev = handler;
+            sender->m_sender_handlers = handler;
+            sender->m_has_sender_handlers = true;
+        }
 
-        if (old != m_handlers.end())
-            m_handlers.erase(old);
+        m_context->addEventReciever(this, handler);
+    }
 
-        m_handlers.push_front(SharedPtr<EventHandler>(handler));
-        m_context->addEventReciever(this, event_type, sender);
+    void Object::resubscribeToEvent(const StringHash& event_type, EventHandler* handler, Object* sender /*= nullptr*/)
+    {
+        if (!handler)
+            return;
+
+        EventHandler* old = findEventHandler(event_type, sender);
+        if (old)
+            removeEventHandler(old);
+
+        subscribeToEvent(event_type, handler, sender);
     }
 
     void Object::unsubscribeFromEvent(const StringHash& event_type)
     {
-        while (true)
+        EventHandler* handler = m_handlers;
+        while (handler)
         {
-            auto handler = findEventHandler(event_type);
-            if (handler != m_handlers.end())
-            {
-                if ((*handler)->getSender())
-                    m_context->removeEventReciever(this, event_type, (*handler)->getSender());
-                else
-                    m_context->removeEventReciever(this, event_type);
-
-                m_handlers.erase(handler);
-            }
-            else
-                break;
+            EventHandler* next = handler->m_next;
+            if (handler->getEventType() == event_type)
+                removeEventHandler(handler);
+            handler = next;
         }
     }
 
@@ -85,12 +122,9 @@ namespace Eris
         if (!sender)
             return;
 
-        auto handler = findEventHandler(event_type, sender);
-        if (handler != m_handlers.end())
-        {
-            m_context->removeEventReciever(this, event_type, (*handler)->getSender());
-            m_handlers.erase(handler);
-        }
+        EventHandler* handler = findEventHandler(event_type, sender);
+        if (handler)
+            removeEventHandler(handler);
     }
 
     void Object::unsubscribeFromEvents(Object* sender)
@@ -98,175 +132,136 @@ namespace Eris
         if (!sender)
             return;
 
-        while (true)
+        EventHandler* handler = m_handlers;
+        while (handler)
         {
-            auto handler = findEventHandler(sender);
-            if (handler != m_handlers.end())
-            {
-                m_context->removeEventReciever(this, (*handler)->getEventType(), (*handler)->getSender());
-                m_handlers.erase(handler);
-            }
-            else
-                break;
+            EventHandler* next = handler->m_next;
+            if (handler->getSender() == sender)
+                removeEventHandler(handler);
+            handler = next;
         }
     }
 
     void Object::unsubscribeFromEvents()
     {
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
-        {
-            if ((*handler)->getSender())
-                m_context->removeEventReciever(this, (*handler)->getEventType(), (*handler)->getSender());
-            else
-                m_context->removeEventReciever(this, (*handler)->getEventType());
-
-            handler = m_handlers.erase(handler);
-        }
+        while (m_handlers)
+            removeEventHandler(m_handlers);
     }
 
     void Object::sendEvent(const StringHash& event_type, Event* event /*= nullptr*/)
     {
+        ERIS_ASSERT(std::this_thread::get_id() == s_main_thread);
+
         WeakPtr<Object> self(this);
         Context* context = m_context;
-        std::unordered_set<Object*> processed;
+        s_events_dispatched.add();
 
-        const std::unordered_set<Object*>* group = context->getEventRecievers(event_type, this);
-        if (group)
+        // Handlers registered for this sender take precedence over the generic ones of the same reciever.
+        EventSubscriberList* specific = m_sender_handlers ? context->getEventRecievers(event_type, this) : nullptr;
+        if (specific)
         {
-            for(auto iter = group->cbegin(); iter != group->cend();)
-            {
-                auto current = iter++;
-                Object* reciever = *current;
-                Object* next = nullptr;
-                if (iter != group->cend())
-                    next = *iter;
-
-                std::size_t oldSize = group->size();
-
-                reciever->onEvent(event_type, event, this);
-
-                if (self.isExpired())
-                    return;
-
-                if (group->size() != oldSize)
-                    iter = group->find(next);
-
-                processed.insert(reciever);
-            }
+            specific->beginDispatch();
+            if (!dispatchEvent(self, *specific, event, nullptr, 0, 0))
+                return; // The specific recievers were released along with the sender.
+            specific->endDispatch();
         }
 
-        group = context->getEventRecievers(event_type);
-        if (group)
+        EventSubscriberList* recievers = context->getEventRecievers(event_type);
+        if (recievers)
         {
-            for (auto iter = group->cbegin(); iter != group->cend();)
+            glm::u32 depth = s_dispatch_depth++;
+            glm::u32 stamp = 0;
+            if (specific && depth < EVENT_STAMP_DEPTH)
             {
-                auto current = iter++;
-                Object* reciever = *current;
-                Object* next = nullptr;
-                if (iter != group->cend())
-                    next = *iter;
-
-                if (processed.empty() || processed.find(reciever) == processed.end())
+                stamp = ++s_dispatch_stamp;
+                for (std::size_t i = 0, count = specific->size(); i < count; i++)
                 {
-                    std::size_t oldSize = group->size();
-
-                    reciever->onEvent(event_type, event, this);
-
-                    if (self.isExpired())
-                        return;
-
-                    if (group->size() != oldSize)
-                        iter = group->find(next);
+                    const EventSubscriber& subscriber = (*specific)[i];
+                    if (subscriber.handler)
+                        subscriber.reciever->m_dispatch_stamps[depth] = stamp;
                 }
             }
+
+            recievers->beginDispatch();
+            dispatchEvent(self, *recievers, event, specific, depth, stamp);
+            recievers->endDispatch();
+            s_dispatch_depth--;
         }
     }
 
-    void Object::onEvent(const StringHash& event_type, const Event* event /*= nullptr*/, Object* sender /*= nullptr*/)
+    void Object::postEvent(const StringHash& event_type, Event* event /*= nullptr*/)
     {
-        auto specific = m_handlers.end();
-        auto non_specific = m_handlers.end();
+        m_context->postEvent(this, event_type, event);
+    }
 
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
-        {
-            if ((*handler)->getEventType() == event_type)
-            {
-                if (!(*handler)->getSender())
-                    non_specific = handler;
-                else if (sender && (*handler)->getSender() == sender)
-                {
-                    specific = handler;
-                    break;
-                }
-            }
-            handler++;
-        }
+    void Object::bufferEvent(const StringHash& event_type, Event* event /*= nullptr*/)
+    {
+        m_context->bufferEvent(this, event_type, event);
+    }
 
-        if (specific != m_handlers.end())
+    bool Object::dispatchEvent(const WeakPtr<Object>& self, const EventSubscriberList& recievers, const Event* event, const EventSubscriberList* skip, glm::u32 depth, glm::u32 stamp)
+    {
+        // Subscribers added during the dispatch wait for the next one, removed ones leave an empty entry.
+        for (std::size_t i = 0, count = recievers.size(); i < count; i++)
         {
-            (*specific)->invoke(event);
-            return;
-        }
+            EventSubscriber subscriber = recievers[i];
+            if (!subscriber.handler)
+                continue;
 
-        if (non_specific != m_handlers.end())
-        {
-            (*non_specific)->invoke(event);
+            if (skip && (stamp ? subscriber.reciever->m_dispatch_stamps[depth] == stamp : skip->contains(subscriber.reciever)))
+                continue;
+
+            subscriber.handler->invoke(event);
+
+            if (self.isExpired())
+                return false;
         }
+
+        return true;
     }
 
-    void Object::removeEventSender(Object* sender)
+    EventHandler* Object::findEventHandler(const StringHash& event_type, Object* sender) const
     {
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
+        // The sender's list for this type only holds the objects listening to that one sender.
+        if (sender)
         {
-            if ((*handler)->getSender() == sender)
-                handler = m_handlers.erase(handler);
-            else
-                handler++;
+            EventSubscriberList* recievers = m_context->getEventRecievers(event_type, sender);
+            return recievers ? recievers->find(this) : nullptr;
         }
-    }
 
-    Object::Iterator Object::findEventHandler(const StringHash& event_type)
-    {
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
+        for (EventHandler* handler = m_handlers; handler; handler = handler->m_next)
         {
-            if ((*handler)->getEventType() == event_type)
+            if (handler->getEventType() == event_type && handler->getSender() == sender)
                 return handler;
-            handler++;
         }
-        return m_handlers.end();
+        return nullptr;
     }
 
-    Object::Iterator Object::findEventHandler(const StringHash& event_type, Object* sender)
+    void Object::removeEventHandler(EventHandler* handler)
     {
-        if (sender == nullptr)
-            return m_handlers.end();
+        ERIS_ASSERT(handler->m_owner == this);
 
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
-        {
-            if ((*handler)->getEventType() == event_type && (*handler)->getSender() == sender)
-                return handler;
-            handler++;
-        }
-        return m_handlers.end();
-    }
+        m_context->removeEventReciever(handler);
 
-    Object::Iterator Object::findEventHandler(Object* sender)
-    {
-        if (sender == nullptr)
-            return m_handlers.end();
+        if (handler->m_prev)
+            handler->m_prev->m_next = handler->m_next;
+        else
+            m_handlers = handler->m_next;
+        if (handler->m_next)
+            handler->m_next->m_prev = handler->m_prev;
 
-        auto handler = m_handlers.begin();
-        while (handler != m_handlers.end())
+        Object* sender = handler->getSender();
+        if (sender)
         {
-            if ((*handler)->getSender() == sender)
-                return handler;
-            handler++;
+            if (handler->m_sender_prev)
+                handler->m_sender_prev->m_sender_next = handler->m_sender_next;
+            else
+                sender->m_sender_handlers = handler->m_sender_next;
+            if (handler->m_sender_next)
+                handler->m_sender_next->m_sender_prev = handler->m_sender_prev;
         }
-        return m_handlers.end();
+
+        handler->m_owner = nullptr;
+        handler->release();
     }
 }
\ No newline at end of file
@@ -23,49 +23,83 @@
 #pragma once
 
 #include <functional>
-#include <list>
 
 #include "Event.h"
 #include "EventHandler.h"
 #include "Collections/StringHash.h"
+#include "Memory/Allocator.h"
 #include "Memory/RefCounted.h"
 #include "Memory/Pointers.h"
 
 namespace Eris
 {
+    /// Nesting depth of sendEvent up to which skipping specific recievers takes constant time.
+    static const glm::u32 EVENT_STAMP_DEPTH = 4;
+
 	class Object : public RefCounted
 	{
         friend class Context;
 
-        using Iterator = std::list<SharedPtr<EventHandler>>::iterator;
-
 	public:
 	    Object(Context* context);
 	    virtual ~Object();
 
+        /// Constant time, the object must not already have a handler for this event type and sender.
         void subscribeToEvent(const StringHash& event_type, EventHandler* handler, Object* sender = nullptr);
+        /// Replaces the handler for this event type and sender if there is one. Searches the sender's specific recievers,
+        /// or without a sender every handler of this object.
+        void resubscribeToEvent(const StringHash& event_type, EventHandler* handler, Object* sender = nullptr);
+
+        /// subscribe<UpdateEvent, Foo, &Foo::handleUpdate>(this) where handleUpdate takes a const UpdateEvent&.
+        template<typename E, typename T, void (T::*Function)(const E&)>
+        void subscribe(T* reciever, Object* sender = nullptr)
+        {
+            ERIS_ASSERT(static_cast<Object*>(reciever) == this);
+            subscribeToEvent(E::getTypeStatic(), new TypedEventHandler<T, E, Function>(reciever), sender);
+        }
+
+        template<typename E>
+        void unsubscribe(Object* sender = nullptr)
+        {
+            if (sender)
+                unsubscribeFromEvent(E::getTypeStatic(), sender);
+            else
+                unsubscribeFromEvent(E::getTypeStatic());
+        }
 
         void unsubscribeFromEvent(const StringHash& event_type);
+        /// Searches only the sender's specific recievers of this event type.
         void unsubscribeFromEvent(const StringHash& event_type, Object* sender);
         void unsubscribeFromEvents(Object* sender);
         void unsubscribeFromEvents();
 
+        /// Main thread only, the subscriber lists and dispatch state are not synchronised. Other threads use postEvent.
         void sendEvent(const StringHash& event_type, Event* event = nullptr);
 
+        /// Queue the event for delivery at the start of the next frame on the main thread, safe to call from any thread.
+        /// The event must be allocated from the context's frame allocator.
+        void postEvent(const StringHash& event_type, Event* event = nullptr);
+        /// Delivered once per frame, merged with pending events of the same type according to its coalescing policy.
+        /// The event must be allocated from the context's frame allocator.
+        void bufferEvent(const StringHash& event_type, Event* event = nullptr);
+
         Context* getContext() const { return m_context; }
 
     protected:
-        virtual void onEvent(const StringHash& event_type, const Event* event = nullptr, Object* sender = nullptr);
-
         Context* m_context;
 
     private:
-        void removeEventSender(Object* sender);
+        bool dispatchEvent(const WeakPtr<Object>& self, const EventSubscriberList& recievers, const Event* event, const EventSubscriberList* skip, glm::u32 depth, glm::u32 stamp);
 
-        Iterator findEventHandler(const StringHash& event_type);
-        Iterator findEventHandler(const StringHash& event_type, Object* sender);
-        Iterator findEventHandler(Object* sender);
+        EventHandler* findEventHandler(const StringHash& event_type, Object* sender) const;
+        void removeEventHandler(EventHandler* handler);
 
-        std::list<SharedPtr<EventHandler>> m_handlers;
+        /// Handlers this object subscribed with.
+        EventHandler* m_handlers;
+        /// Handlers other objects subscribed specifically to events sent by this object.
+        EventHandler* m_sender_handlers;
+        bool m_has_sender_handlers;
+        /// Set on the specific recievers of the sendEvent at each nesting depth, so its generic pass can skip them.
+        glm::u32 m_dispatch_stamps[EVENT_STAMP_DEPTH];
 	};
 }
@@ -1,5 +1,5 @@
 //
-// Copyright (c) 2008-2014 the Eris project.
+// Copyright (c) 2013-2015 the Eris project.
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -21,104 +21,528 @@
 //
 
 #include "Profiler.h"
+#include "Log.h"
+
+#include "IO/File.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
 
 namespace Eris
 {
-    AutoProfilerBlock::AutoProfilerBlock(Profiler* profiler, const std::string& name) :
-        m_profiler(profiler)
+    ProfilerThreadBuffer* Profiler::s_buffers[PROFILER_MAX_THREADS] = { nullptr };
+    std::atomic<glm::u32> Profiler::s_buffer_count(0);
+    glm::u64 Profiler::s_start_ticks = 0;
+    glm::f64 Profiler::s_start_time = 0;
+    std::atomic_flag Profiler::s_counter_lock = ATOMIC_FLAG_INIT;
+    ProfilerCounter* Profiler::s_counters[PROFILER_MAX_COUNTERS] = { nullptr };
+    glm::u64 Profiler::s_counter_samples = 0;
+    glm::u64 Profiler::s_counter_ticks[PROFILER_COUNTER_HISTORY] = { 0 };
+
+    static const ProfilerZone FRAME_ZONE = { "Frame", __FILE__, __LINE__ };
+
+    static glm::f64 getWallTime()
     {
-        profiler->beginBlock(name);
+        return std::chrono::duration<glm::f64>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
     }
 
-    AutoProfilerBlock::~AutoProfilerBlock()
+    ProfilerCounter::ProfilerCounter(const char* name, ProfilerCounterType type) :
+        m_name(name),
+        m_type(type),
+        m_value(0)
     {
-        m_profiler->endBlock();
+        std::fill(m_history, m_history + PROFILER_COUNTER_HISTORY, 0);
+        Profiler::addCounter(this);
     }
 
-    ProfilerBlock::ProfilerBlock(ProfilerBlock* parent, const std::string& name) :
-        m_name(name),
-        m_parent(parent),
-        m_count(0),
-        m_total_time(0),
-        m_max_time(0)
+    ProfilerCounter::~ProfilerCounter()
     {
+        Profiler::removeCounter(this);
     }
 
-    void ProfilerBlock::begin()
+    glm::i64 ProfilerCounter::getValue(glm::u32 frames_ago) const
     {
-        m_timer.reset();
-        m_count++;
+        glm::u64 samples = Profiler::getCounterSampleCount();
+        if (frames_ago >= samples || frames_ago >= PROFILER_COUNTER_HISTORY)
+            return 0;
+
+        return m_history[(samples - 1 - frames_ago) & (PROFILER_COUNTER_HISTORY - 1)];
     }
-    
-    void ProfilerBlock::end()
+
+    void ProfilerCounter::sample(glm::u64 index)
     {
-        glm::f64 elapsed = m_timer.getElapsed();
-        if (elapsed > m_max_time)
-            m_max_time = elapsed;
-        m_total_time += elapsed;
+        if (m_type == ProfilerCounterType::COUNTER)
+            m_history[index & (PROFILER_COUNTER_HISTORY - 1)] = m_value.exchange(0, std::memory_order_relaxed);
+        else
+            m_history[index & (PROFILER_COUNTER_HISTORY - 1)] = m_value.load(std::memory_order_relaxed);
     }
 
-    ProfilerBlock* ProfilerBlock::getChild(const std::string& name)
+    ProfilerThreadBuffer::ProfilerThreadBuffer(glm::u32 thread_index) :
+        m_write(0),
+        m_thread_index(thread_index)
     {
-        auto find = m_children.find(name);
-        if (find != m_children.end())
-            return find->second;
+        m_name[0] = '\0';
+    }
+
+    glm::u64 ProfilerThreadBuffer::read(std::vector<ProfilerEvent>& out, glm::u64 from) const
+    {
+        glm::u64 end = m_write.load(std::memory_order_acquire);
+        glm::u64 begin = end > PROFILER_BUFFER_SIZE ? std::max(from, end - PROFILER_BUFFER_SIZE) : from;
+
+        std::size_t offset = out.size();
+        for (glm::u64 i = begin; i < end; i++)
+            out.push_back(m_events[i & (PROFILER_BUFFER_SIZE - 1)]);
 
-        SharedPtr<ProfilerBlock> child(new ProfilerBlock(this, name));
-        m_children[name] = child;   
-        return child;
+        // Anything the owner wrapped over while we copied may be torn, including the slot of the event it is writing right now.
+        glm::u64 written = m_write.load(std::memory_order_acquire);
+        if (begin < end && written + 1 > begin + PROFILER_BUFFER_SIZE)
+        {
+            std::size_t torn = static_cast<std::size_t>(std::min<glm::u64>(written + 1 - PROFILER_BUFFER_SIZE - begin, end - begin));
+            out.erase(out.begin() + offset, out.begin() + offset + torn);
+        }
+
+        return std::max(from, end);
     }
 
-    ProfilerThreadBlock::ProfilerThreadBlock() :
-        m_root(new ProfilerBlock(nullptr, "Root")),
-        m_current(m_root)
+    void ProfilerThreadBuffer::setName(const char* name)
     {
+        strncpy(m_name, name, PROFILER_THREAD_NAME_SIZE - 1);
+        m_name[PROFILER_THREAD_NAME_SIZE - 1] = '\0';
     }
 
-    void ProfilerThreadBlock::beginBlock(const std::string& name)
+    Profiler::Profiler(Context* context) :
+        Object(context),
+        m_capture_frames(0),
+        m_capture_first_frame(0),
+        m_capture_start(0),
+        m_frame_start(0),
+        m_frame_count(0),
+        m_hitch_threshold(0.f),
+        m_hitch_window(0.0),
+        m_hitch_trailing_frames(0),
+        m_hitch_count(0),
+        m_hitch_frame(0)
     {
-        m_current = m_current->getChild(name);
-        m_current->begin();
+        s_start_ticks = __rdtsc();
+        s_start_time = getWallTime();
     }
 
-    void ProfilerThreadBlock::endBlock()
+    void Profiler::beginFrame(glm::u64 frame_number)
     {
-        if (m_current != m_root)
+        getThreadBuffer()->record(&FRAME_ZONE, ProfilerEventType::FRAME);
+        m_frame_start = __rdtsc();
+
+        if (!isCapturing())
+            return;
+
+        // Drained every frame so a capture is only limited by memory, not by the size of the rings.
+        collectCapture();
+
+        // The first marker opens the first captured frame, every later one closes a frame.
+        if (!m_capture_first_frame)
+            m_capture_first_frame = frame_number;
+        else if (--m_capture_frames == 0)
         {
-            m_current->end();
-            m_current = m_current->getParent();
+            writeTrace(m_capture_path, m_capture_threads, m_capture_start, frame_number);
+            m_capture_threads.clear();
         }
     }
 
-    Profiler::Profiler(Context* context) :
-        Object(context)
+    void Profiler::endFrame(glm::u64 frame_number)
+    {
+        sampleCounters();
+
+        if (!m_hitch_threshold || !m_frame_start)
+            return;
+
+        glm::u64 ticks = __rdtsc() - m_frame_start;
+
+        // The median ignores the odd slow frame, so one hitch does not hide the next.
+        if (m_frame_count >= PROFILER_HITCH_HISTORY)
+        {
+            glm::u64 sorted[PROFILER_HITCH_HISTORY];
+            std::copy(m_frame_ticks, m_frame_ticks + PROFILER_HITCH_HISTORY, sorted);
+            std::nth_element(sorted, sorted + PROFILER_HITCH_HISTORY / 2, sorted + PROFILER_HITCH_HISTORY);
+            glm::u64 median = sorted[PROFILER_HITCH_HISTORY / 2];
+
+            if (ticks > median * m_hitch_threshold)
+            {
+                glm::f64 ticks_per_ms = getTicksPerSecond() / 1000.0;
+                Log::warnf("Hitch in frame %llu: %.2f ms, median %.2f ms", frame_number, ticks / ticks_per_ms, median / ticks_per_ms);
+
+                if (!m_hitch_frame && m_hitch_count < PROFILER_HITCH_MAX_CAPTURES)
+                    m_hitch_frame = frame_number;
+
+                m_hitch_count++;
+            }
+        }
+
+        m_frame_ticks[m_frame_count++ % PROFILER_HITCH_HISTORY] = ticks;
+
+        // Written a few frames late so the trace also shows what the hitch led to. Writing is a hitch of its own,
+        // but it happens between frames so it is not measured.
+        if (m_hitch_frame && frame_number >= m_hitch_frame + m_hitch_trailing_frames)
+        {
+            writeHitch(frame_number);
+            m_hitch_frame = 0;
+        }
+    }
+
+    bool Profiler::capture(glm::u32 frames, const Path& path)
+    {
+        if (isCapturing())
+        {
+            Log::error("Profiler capture already running");
+            return false;
+        }
+
+        if (!frames)
+            return false;
+
+        m_capture_threads.clear();
+        for (glm::u32 i = 0; i < getThreadBufferCount(); i++)
+        {
+            ProfilerThreadBuffer* buffer = getThreadBuffer(i);
+            m_capture_threads.push_back(CaptureThread{ buffer ? buffer->getWritePosition() : 0 });
+        }
+
+        m_capture_frames = frames;
+        m_capture_first_frame = 0;
+        m_capture_start = __rdtsc();
+        m_capture_path = path;
+
+        Log::infof("Profiler capturing %u frames", frames);
+        return true;
+    }
+
+    void Profiler::setThreadName(const char* name)
+    {
+        getThreadBuffer()->setName(name);
+    }
+
+    void Profiler::setHitchDetection(glm::f32 threshold, glm::f64 window, const Path& directory, glm::u32 trailing_frames)
+    {
+        m_hitch_threshold = threshold;
+        m_hitch_window = window;
+        m_hitch_directory = directory;
+        m_hitch_trailing_frames = trailing_frames;
+        m_hitch_frame = 0;
+        m_frame_count = 0;
+    }
+
+    std::vector<ProfilerCounter*> Profiler::getCounters()
+    {
+        std::vector<ProfilerCounter*> out;
+
+        while (s_counter_lock.test_and_set(std::memory_order_acquire));
+
+        for (ProfilerCounter* counter : s_counters)
+        {
+            if (counter)
+                out.push_back(counter);
+        }
+
+        s_counter_lock.clear(std::memory_order_release);
+
+        return out;
+    }
+
+    glm::u64 Profiler::getCounterSampleCount()
+    {
+        return s_counter_samples;
+    }
+
+    glm::u32 Profiler::getThreadBufferCount()
+    {
+        return std::min(s_buffer_count.load(), PROFILER_MAX_THREADS);
+    }
+
+    ProfilerThreadBuffer* Profiler::getThreadBuffer(glm::u32 index)
     {
+        // Null while the thread that claimed the slot is still creating its buffer.
+        return index < PROFILER_MAX_THREADS ? s_buffers[index] : nullptr;
     }
 
-    void Profiler::beginBlock(const std::string& name)
+    glm::f64 Profiler::getTicksPerSecond()
     {
-        auto thread_block = getThreadBlock(std::this_thread::get_id());
-        if (thread_block)
-            thread_block->beginBlock(name);
+        ERIS_ASSERT(s_start_ticks);
+
+        glm::f64 elapsed = getWallTime() - s_start_time;
+        if (elapsed <= 0)
+            return 1.0;
+
+        return (__rdtsc() - s_start_ticks) / elapsed;
+    }
+
+    std::vector<LockStats> Profiler::getLockStats() const
+    {
+        return LockRegistry::getStats();
+    }
+
+    void Profiler::collectCapture()
+    {
+        // Threads that started recording after the capture began are read from their first event.
+        m_capture_threads.resize(getThreadBufferCount(), CaptureThread{ 0 });
+
+        for (glm::u32 i = 0; i < m_capture_threads.size(); i++)
+        {
+            ProfilerThreadBuffer* buffer = getThreadBuffer(i);
+            if (!buffer)
+                continue;
+
+            CaptureThread& thread = m_capture_threads[i];
+            std::size_t count = thread.events.size();
+            glm::u64 position = thread.position;
+            thread.position = buffer->read(thread.events, position);
+
+            if (thread.position - position > thread.events.size() - count)
+                Log::warnf("Profiler capture lost %u events on thread %u", static_cast<glm::u32>(thread.position - position - (thread.events.size() - count)), i);
+        }
+    }
+
+    void Profiler::sampleCounters()
+    {
+        while (s_counter_lock.test_and_set(std::memory_order_acquire));
+
+        for (ProfilerCounter* counter : s_counters)
+        {
+            if (counter)
+                counter->sample(s_counter_samples);
+        }
+
+        s_counter_lock.clear(std::memory_order_release);
+
+        s_counter_ticks[s_counter_samples & (PROFILER_COUNTER_HISTORY - 1)] = __rdtsc();
+        s_counter_samples++;
+    }
+
+    void Profiler::writeHitch(glm::u64 frame_number)
+    {
+        // The thread rings are the rolling window, so nothing is copied until a hitch is written.
+        glm::u64 end = __rdtsc();
+        glm::u64 window = static_cast<glm::u64>(m_hitch_window * getTicksPerSecond());
+        glm::u64 start = end > window ? end - window : 0;
+
+        std::vector<CaptureThread> threads(getThreadBufferCount(), CaptureThread{ 0 });
+        for (glm::u32 i = 0; i < threads.size(); i++)
+        {
+            ProfilerThreadBuffer* buffer = getThreadBuffer(i);
+            if (buffer)
+                buffer->read(threads[i].events);
+        }
+
+        writeTrace(Path(m_hitch_directory) /= "hitch_" + std::to_string(m_hitch_frame) + ".json", threads, start, frame_number);
+    }
+
+    void Profiler::writeTrace(const Path& path, const std::vector<CaptureThread>& threads, glm::u64 start, glm::u64 last_frame)
+    {
+        glm::f64 ticks_per_us = getTicksPerSecond() / 1000000.0;
+
+        // Only the thread calling beginFrame records markers and the last one is last_frame.
+        glm::u64 frame_number = last_frame + 1;
+        for (const CaptureThread& thread : threads)
+        {
+            for (const ProfilerEvent& event : thread.events)
+            {
+                if (event.time >= start && event.type == ProfilerEventType::FRAME)
+                    frame_number--;
+            }
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+        writer.Key("displayTimeUnit");
+        writer.String("ms");
+        writer.Key("traceEvents");
+        writer.StartArray();
+
+        for (glm::u32 i = 0; i < threads.size(); i++)
+        {
+            ProfilerThreadBuffer* thread_buffer = getThreadBuffer(i);
+            std::string name = thread_buffer && thread_buffer->getName()[0] ? thread_buffer->getName() : "Thread " + std::to_string(i);
+
+            writer.StartObject();
+            writer.Key("name");
+            writer.String("thread_name");
+            writer.Key("ph");
+            writer.String("M");
+            writer.Key("pid");
+            writer.Uint(0);
+            writer.Key("tid");
+            writer.Uint(i);
+            writer.Key("args");
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(name.c_str(), static_cast<rapidjson::SizeType>(name.size()));
+            writer.EndObject();
+            writer.EndObject();
+
+            // Scopes that were already open when the capture started have no begin and are skipped, scopes still
+            // open at the end are closed at the last event so every slice is balanced.
+            std::vector<const ProfilerZone*> open;
+            glm::f64 last_ts = 0.0;
+
+            for (const ProfilerEvent& event : threads[i].events)
+            {
+                if (event.time < start)
+                    continue;
+
+                glm::f64 ts = (event.time - start) / ticks_per_us;
+                std::string frame_name;
+                const char* event_name = event.zone->name;
+                last_ts = ts;
+
+                if (event.type == ProfilerEventType::END)
+                {
+                    if (open.empty())
+                        continue;
+
+                    open.pop_back();
+                }
+                else if (event.type == ProfilerEventType::BEGIN)
+                {
+                    open.push_back(event.zone);
+                }
+                else
+                {
+                    frame_name = "Frame " + std::to_string(frame_number++);
+                    event_name = frame_name.c_str();
+                }
+
+                writer.StartObject();
+                writer.Key("name");
+                writer.String(event_name);
+                writer.Key("ph");
+                writer.String(event.type == ProfilerEventType::BEGIN ? "B" : event.type == ProfilerEventType::END ? "E" : "i");
+                writer.Key("ts");
+                writer.Double(ts);
+                writer.Key("pid");
+                writer.Uint(0);
+                writer.Key("tid");
+                writer.Uint(i);
+
+                if (event.type == ProfilerEventType::FRAME)
+                {
+                    writer.Key("s");
+                    writer.String("g");
+                }
+                else if (event.type == ProfilerEventType::BEGIN)
+                {
+                    writer.Key("args");
+                    writer.StartObject();
+                    writer.Key("file");
+                    writer.String(event.zone->file);
+                    writer.Key("line");
+                    writer.Uint(event.zone->line);
+                    writer.EndObject();
+                }
+
+                writer.EndObject();
+            }
+
+            while (!open.empty())
+            {
+                writer.StartObject();
+                writer.Key("name");
+                writer.String(open.back()->name);
+                writer.Key("ph");
+                writer.String("E");
+                writer.Key("ts");
+                writer.Double(last_ts);
+                writer.Key("pid");
+                writer.Uint(0);
+                writer.Key("tid");
+                writer.Uint(i);
+                writer.EndObject();
+                open.pop_back();
+            }
+        }
+
+        // Counters are exported as one track each with the value of every frame in range, placed at the frame's end.
+        glm::u64 first_sample = s_counter_samples > PROFILER_COUNTER_HISTORY ? s_counter_samples - PROFILER_COUNTER_HISTORY : 0;
+        for (ProfilerCounter* counter : getCounters())
+        {
+            for (glm::u64 i = first_sample; i < s_counter_samples; i++)
+            {
+                glm::u64 ticks = s_counter_ticks[i & (PROFILER_COUNTER_HISTORY - 1)];
+                if (ticks < start)
+                    continue;
+
+                writer.StartObject();
+                writer.Key("name");
+                writer.String(counter->getName());
+                writer.Key("ph");
+                writer.String("C");
+                writer.Key("ts");
+                writer.Double((ticks - start) / ticks_per_us);
+                writer.Key("pid");
+                writer.Uint(0);
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("value");
+                writer.Int64(counter->m_history[i & (PROFILER_COUNTER_HISTORY - 1)]);
+                writer.EndObject();
+                writer.EndObject();
+            }
+        }
+
+        writer.EndArray();
+        writer.EndObject();
+
+        SharedPtr<File> file(new File(m_context, path, FileMode::WRITE));
+        if (!file->isOpened() || file->write(buffer.GetString(), buffer.GetSize()) != buffer.GetSize())
+        {
+            Log::errorf("Could not write profiler capture %s", path.string().c_str());
+            return;
+        }
+
+        Log::infof("Profiler capture written to %s", path.string().c_str());
     }
 
-    void Profiler::endBlock()
+    void Profiler::addCounter(ProfilerCounter* counter)
     {
-        auto thread_block = getThreadBlock(std::this_thread::get_id());
-        if (thread_block)
-            thread_block->endBlock();
+        // Counters register during static initialisation, so this only relies on constant initialised state.
+        while (s_counter_lock.test_and_set(std::memory_order_acquire));
+
+        glm::u32 i = 0;
+        while (i < PROFILER_MAX_COUNTERS && s_counters[i])
+            i++;
+
+        if (i < PROFILER_MAX_COUNTERS)
+            s_counters[i] = counter;
+
+        s_counter_lock.clear(std::memory_order_release);
+    }
+
+    void Profiler::removeCounter(ProfilerCounter* counter)
+    {
+        while (s_counter_lock.test_and_set(std::memory_order_acquire));
+
+        for (ProfilerCounter*& slot : s_counters)
+        {
+            if (slot == counter)
+                slot = nullptr;
+        }
+
+        s_counter_lock.clear(std::memory_order_release);
     }
 
-    ProfilerThreadBlock* Profiler::getThreadBlock(std::thread::id thread_id)
+    ProfilerThreadBuffer* Profiler::createThreadBuffer()
     {
-        std::lock_guard<SpinLock> lock(m_lock);
+        // Buffers outlive their threads so a profile can still be exported after a thread stopped. Threads past
+        // PROFILER_MAX_THREADS still record, they just are not exported.
+        glm::u32 index = s_buffer_count++;
+        ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer(index);
+        if (index < PROFILER_MAX_THREADS)
+            s_buffers[index] = buffer;
 
-        auto find = m_thread_blocks.find(thread_id);
-        if (find != m_thread_blocks.end())
-            return find->second;
- 
-        SharedPtr<ProfilerThreadBlock> new_thread_block(new ProfilerThreadBlock());
-        m_thread_blocks[std::this_thread::get_id()] = new_thread_block;
-        return new_thread_block;
+        return buffer;
     }
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 //
-// Copyright (c) 2008-2014 the Eris project.
+// Copyright (c) 2013-2015 the Eris project.
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy
 // of this software and associated documentation files (the "Software"), to deal
@@ -24,72 +24,241 @@
 
 #include "Core/Context.h"
 #include "Core/Object.h"
-#include "Core/Timer.h"
-#include "Memory/RefCounted.h"
-#include "Thread/SpinLock.h"
+#include "IO/Types.h"
+#include "Memory/Tracking.h"
+#include "Thread/LockStats.h"
+
+#include <intrin.h>
+#include <vector>
 
 namespace Eris
 {
-    class AutoProfilerBlock
+    /// Events kept per thread, must be a power of two. Also bounds how far back a hitch capture reaches.
+    static const glm::u32 PROFILER_BUFFER_SIZE = 65536;
+    static const glm::u32 PROFILER_MAX_THREADS = 64;
+    static const glm::u32 PROFILER_THREAD_NAME_SIZE = 32;
+    /// Frames the rolling median frame time is taken over, hitch detection starts once that many were seen.
+    static const glm::u32 PROFILER_HITCH_HISTORY = 128;
+    static const glm::u32 PROFILER_HITCH_MAX_CAPTURES = 16;
+    static const glm::u32 PROFILER_MAX_COUNTERS = 64;
+    /// Frames of counter values kept, must be a power of two.
+    static const glm::u32 PROFILER_COUNTER_HISTORY = 1024;
+
+    /// Static description of a profiled scope, events refer to it by address.
+    struct ProfilerZone
     {
-    public:
-        AutoProfilerBlock(Profiler* profile, const std::string& name);
-        ~AutoProfilerBlock();
+        const char* name;
+        const char* file;
+        glm::u32 line;
+    };
 
-    private:
-        WeakPtr<Profiler> m_profiler;
+    enum class ProfilerEventType : glm::u8
+    {
+        BEGIN,
+        END,
+        FRAME
     };
 
-    class ProfilerBlock : public RefCounted
+    struct ProfilerEvent
     {
+        glm::u64 time;
+        const ProfilerZone* zone;
+        ProfilerEventType type;
+    };
+
+    enum class ProfilerCounterType : glm::u8
+    {
+        /// Summed over a frame and reset when the frame ends, like draw calls.
+        COUNTER,
+        /// Keeps the last value set, like memory in use.
+        GAUGE
+    };
+
+    /// A named value sampled at the end of every frame. Any thread may update it, counters usually live at namespace
+    /// scope and the name must outlive them.
+    class ProfilerCounter
+    {
+        friend class Profiler;
+
     public:
-        ProfilerBlock(ProfilerBlock* parent, const std::string& name);
+        ProfilerCounter(const char* name, ProfilerCounterType type = ProfilerCounterType::COUNTER);
+        ~ProfilerCounter();
+
+        void add(glm::i64 delta = 1)
+        {
+#ifndef ERIS_PROFILING_DISABLED
+            m_value.fetch_add(delta, std::memory_order_relaxed);
+#endif
+        }
 
-        void begin();
-        void end();
+        void set(glm::i64 value)
+        {
+#ifndef ERIS_PROFILING_DISABLED
+            m_value.store(value, std::memory_order_relaxed);
+#endif
+        }
 
-        ProfilerBlock* getChild(const std::string& name);
-        ProfilerBlock* getParent() const { return m_parent; }
+        const char* getName() const { return m_name; }
+        ProfilerCounterType getType() const { return m_type; }
+
+        /// Value sampled at the end of a past frame, zero is the last finished one. Only valid on the main thread.
+        glm::i64 getValue(glm::u32 frames_ago = 0) const;
 
     private:
-        std::string m_name;
-        Timer m_timer;
-        glm::u64 m_count;
-        glm::f64 m_total_time;
-        glm::f64 m_max_time;
-        WeakPtr<ProfilerBlock> m_parent;
-        std::unordered_map<std::string, SharedPtr<ProfilerBlock>> m_children;
+        void sample(glm::u64 index);
+
+        const char* m_name;
+        ProfilerCounterType m_type;
+        std::atomic<glm::i64> m_value;
+        glm::i64 m_history[PROFILER_COUNTER_HISTORY];
     };
 
-    class ProfilerThreadBlock : public RefCounted
+    /// Events recorded by one thread. Only the owning thread writes, when the ring is full the oldest events are
+    /// overwritten.
+    class ProfilerThreadBuffer
     {
     public:
-        ProfilerThreadBlock();
+        ProfilerThreadBuffer(glm::u32 thread_index);
 
-        void beginBlock(const std::string& name);
-        void endBlock();
+        void record(const ProfilerZone* zone, ProfilerEventType type)
+        {
+            glm::u64 write = m_write.load(std::memory_order_relaxed);
+            ProfilerEvent& event = m_events[write & (PROFILER_BUFFER_SIZE - 1)];
+            event.time = __rdtsc();
+            event.zone = zone;
+            event.type = type;
+            m_write.store(write + 1, std::memory_order_release);
+        }
 
-        ProfilerBlock* getRoot() const { return m_root; }
-        ProfilerBlock* getCurrent() const { return m_current; }
+        /// Copies the events written since position from, oldest first, and returns the position to continue from.
+        /// Safe from any thread, events the owner overwrote before or while they were copied are dropped.
+        glm::u64 read(std::vector<ProfilerEvent>& out, glm::u64 from = 0) const;
+        glm::u64 getWritePosition() const { return m_write.load(std::memory_order_acquire); }
+
+        void setName(const char* name);
+        const char* getName() const { return m_name; }
+        glm::u32 getThreadIndex() const { return m_thread_index; }
 
     private:
-        SharedPtr<ProfilerBlock> m_root;
-        SharedPtr<ProfilerBlock> m_current;
+        ProfilerEvent m_events[PROFILER_BUFFER_SIZE];
+        std::atomic<glm::u64> m_write;
+        glm::u32 m_thread_index;
+        char m_name[PROFILER_THREAD_NAME_SIZE];
     };
 
+    /// Scopes record into a buffer owned by their thread, so they take no lock and never allocate after the first
+    /// event of a thread. Timestamps are raw CPU ticks, see getTicksPerSecond.
     class Profiler : public Object
     {
+        friend class ProfilerCounter;
+
     public:
         Profiler(Context* context);
 
-        void beginBlock(const std::string& name);
-        void endBlock();
+        /// Called by the Clock at the start of every frame on the main thread.
+        void beginFrame(glm::u64 frame_number);
+        void endFrame(glm::u64 frame_number);
+
+        /// Records every thread for the next frames and then writes them to path as Chrome trace event JSON, which
+        /// Perfetto and about:tracing can open.
+        bool capture(glm::u32 frames, const Path& path);
+        bool isCapturing() const { return m_capture_frames > 0; }
+
+        /// Flags every frame that takes longer than threshold times the rolling median as a hitch, and for the first
+        /// few writes the last window seconds of every thread to directory once trailing_frames more frames ran. A
+        /// threshold of zero disables detection.
+        void setHitchDetection(glm::f32 threshold, glm::f64 window, const Path& directory, glm::u32 trailing_frames = 4);
+        glm::u32 getHitchCount() const { return m_hitch_count; }
+
+        static ProfilerThreadBuffer* getThreadBuffer()
+        {
+            static ERIS_THREAD_LOCAL ProfilerThreadBuffer* t_buffer = nullptr;
 
-        ProfilerThreadBlock* getThreadBlock(std::thread::id);
+            if (!t_buffer)
+                t_buffer = createThreadBuffer();
+
+            return t_buffer;
+        }
+
+        /// Names the calling thread in exported profiles, the name is copied.
+        static void setThreadName(const char* name);
+
+        /// Buffers of the threads that recorded events, in the order they started recording.
+        static glm::u32 getThreadBufferCount();
+        static ProfilerThreadBuffer* getThreadBuffer(glm::u32 index);
+
+        /// Measured against the wall clock over the profiler's lifetime, so it gets more accurate the longer it runs.
+        static glm::f64 getTicksPerSecond();
+
+        /// Every registered counter, in no particular order.
+        static std::vector<ProfilerCounter*> getCounters();
+        /// Frames sampled so far, counter histories hold the last PROFILER_COUNTER_HISTORY of them.
+        static glm::u64 getCounterSampleCount();
+
+        /// Contention counters of every named lock, empty unless ERIS_LOCK_STATS is defined.
+        std::vector<LockStats> getLockStats() const;
 
     private:
-        SpinLock m_lock;
-        std::unordered_map<std::thread::id, SharedPtr<ProfilerThreadBlock>> m_thread_blocks;
+        struct CaptureThread
+        {
+            glm::u64 position;
+            std::vector<ProfilerEvent> events;
+        };
+
+        void collectCapture();
+        void sampleCounters();
+        void writeHitch(glm::u64 frame_number);
+        void writeTrace(const Path& path, const std::vector<CaptureThread>& threads, glm::u64 start, glm::u64 last_frame);
+
+        static ProfilerThreadBuffer* createThreadBuffer();
+        static void addCounter(ProfilerCounter* counter);
+        static void removeCounter(ProfilerCounter* counter);
+
+        std::vector<CaptureThread> m_capture_threads;
+        glm::u32 m_capture_frames;
+        glm::u64 m_capture_first_frame;
+        glm::u64 m_capture_start;
+        Path m_capture_path;
+
+        glm::u64 m_frame_start;
+        glm::u64 m_frame_ticks[PROFILER_HITCH_HISTORY];
+        glm::u32 m_frame_count;
+        glm::f32 m_hitch_threshold;
+        glm::f64 m_hitch_window;
+        glm::u32 m_hitch_trailing_frames;
+        glm::u32 m_hitch_count;
+        glm::u64 m_hitch_frame;
+        Path m_hitch_directory;
+
+        static ProfilerThreadBuffer* s_buffers[PROFILER_MAX_THREADS];
+        static std::atomic<glm::u32> s_buffer_count;
+        static glm::u64 s_start_ticks;
+        static glm::f64 s_start_time;
+
+        static std::atomic_flag s_counter_lock;
+        static ProfilerCounter* s_counters[PROFILER_MAX_COUNTERS];
+        static glm::u64 s_counter_samples;
+        static glm::u64 s_counter_ticks[PROFILER_COUNTER_HISTORY];
+    };
+
+    class ProfilerScope
+    {
+    public:
+        ProfilerScope(const ProfilerZone* zone) :
+            m_zone(zone),
+            m_buffer(Profiler::getThreadBuffer())
+        {
+            m_buffer->record(m_zone, ProfilerEventType::BEGIN);
+        }
+
+        ~ProfilerScope()
+        {
+            m_buffer->record(m_zone, ProfilerEventType::END);
+        }
+
+    private:
+        const ProfilerZone* m_zone;
+        ProfilerThreadBuffer* m_buffer;
     };
 
     template<> inline void Context::registerModule(Profiler* module)
@@ -104,8 +273,17 @@ namespace Eris
     }
 }
 
-#ifdef _DEBUG
-#define PROFILE(name) Eris::AutoProfilerBlock block_ ## name (m_context->getModule<Profiler>(), #name)
+#ifdef ERIS_ALLOCATION_TRACKING
+#define PROFILE_ALLOCATIONS(name) Eris::AllocationScope allocation_scope_ ## name (#name);
+#else
+#define PROFILE_ALLOCATIONS(name)
+#endif
+
+// Enabled in every build, define ERIS_PROFILING_DISABLED to compile the scopes out entirely.
+#ifndef ERIS_PROFILING_DISABLED
+#define PROFILE(name) PROFILE_ALLOCATIONS(name) \
+    static const Eris::ProfilerZone profiler_zone_ ## name = { #name, __FILE__, __LINE__ }; \
+    Eris::ProfilerScope profiler_scope_ ## name (&profiler_zone_ ## name)
 #else
-#define PROFILE(name)
+#define PROFILE(name) PROFILE_ALLOCATIONS(name)
 #endif
\ No newline at end of file
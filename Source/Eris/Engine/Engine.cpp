@@ -22,6 +22,7 @@
 
 #include "Engine.h"
 #include "Events.h"
+#include "FrameGraph.h"
 #include "Locale.h"
 #include "Settings.h"
 
@@ -30,6 +31,8 @@
 #include "Graphics/ShaderProgram.h"
 
 #include "Core/Clock.h"
+#include "Core/Events.h"
+#include "Core/FrameStats.h"
 #include "Core/Log.h"
 #include "Core/Profiler.h"
 #include "Collections/Functions.h"
@@ -37,8 +40,10 @@
 #include "Graphics/Renderer.h"
 #include "Input/Input.h"
 #include "IO/FileSystem.h"
+#include "Memory/Tracking.h"
 #include "Resource/Image.h"
 #include "Resource/ResourceCache.h"
+#include "Thread/JobSystem.h"
 
 #include "../gitversion.h"
 
@@ -46,24 +51,35 @@
 
 namespace Eris
 {
+    static ProfilerCounter s_pool_bytes("PoolBytes", ProfilerCounterType::GAUGE);
+
     Engine::Engine(Context* context) :
         Object(context),
         m_exitcode(EXIT_OK),
-        m_exiting(false)
+        m_exiting(false),
+        m_pool_frame_report(false),
+        m_zero_allocation_frame(0),
+        m_frame_graph_dump_frame(0),
+        m_profile_capture_frame(0),
+        m_profile_capture_frames(0),
+        m_frame_graph(new FrameGraph(context))
     {
         context->registerModule(new Log(context));
         context->registerModule(new Clock(context));
         context->registerModule(this);
         context->registerModule(new FileSystem(context));
+        context->registerModule(new FrameStats(context));
         context->registerModule(new Graphics(context));
         context->registerModule(new Input(context));
+        context->registerModule(new JobSystem(context));
         context->registerModule(new Locale(context));
         context->registerModule(new Renderer(context));
         context->registerModule(new ResourceCache(context));
         context->registerModule(new Settings(context));
         context->registerModule(new Profiler(context));
 
-        subscribeToEvent(ExitRequestedEvent::getTypeStatic(), HANDLER(Engine, handleExitRequest));
+        subscribe<ExitRequestedEvent, Engine, &Engine::handleExitRequest>(this);
+        subscribe<EndFrameEvent, Engine, &Engine::handleEndFrame>(this);
     }
 
     void Engine::initialize()
@@ -73,13 +89,16 @@ namespace Eris
         ResourceCache* rc = m_context->getModule<ResourceCache>();
         Graphics* graphics = m_context->getModule<Graphics>();
         Input* input = m_context->getModule<Input>();
+        JobSystem* jobs = m_context->getModule<JobSystem>();
         Settings* settings = m_context->getModule<Settings>();
         Locale* locale = m_context->getModule<Locale>();
         Renderer* renderer = m_context->getModule<Renderer>();
+        Profiler* profiler = m_context->getModule<Profiler>();
 
         log->open(fs->getApplicationPreferencesDir() /= "engine.log");
 
         logSystemInfo();
+        Profiler::setThreadName("Main");
 
         fs->addPath(fs->getApplicationPreferencesDir());
         fs->addPath(fs->getDocumentsDir());
@@ -91,6 +110,13 @@ namespace Eris
         rc->initialize();
 
         settings->load();
+        m_zero_allocation_frame = settings->getI32("Debug/ZeroAllocationFrame", 0);
+        m_frame_graph_dump_frame = settings->getI32("Debug/FrameGraphDumpFrame", 0);
+        m_profile_capture_frame = settings->getI32("Debug/ProfileCaptureFrame", 0);
+        m_profile_capture_frames = settings->getI32("Debug/ProfileCaptureFrames", 10);
+        m_pool_frame_report = settings->getBool("Debug/PoolFrameReport", false);
+        profiler->setHitchDetection(settings->getF32("Debug/HitchThreshold", 0.f), settings->getF64("Debug/HitchWindow", 3.0), fs->getApplicationPreferencesDir());
+        jobs->initialize(settings->getI32("General/WorkerThreads", 0));
         locale->load(settings->getString("General/Language", "enGB"));
 
         if (!glfwInit())
@@ -134,25 +160,37 @@ namespace Eris
 
             clock->beginFrame(delta_time);
 
+            {
+                PROFILE(PostedEvents);
+                m_context->dispatchPostedEvents();
+            }
+            {
+                PROFILE(BufferedEvents);
+                m_context->dispatchBufferedEvents();
+            }
+
             UpdateEvent* event = m_context->getFrameAllocator().newInstance<UpdateEvent>();
             event->time_step = delta_time;
 
             {
                 PROFILE(Update);
                 sendEvent(UpdateEvent::getTypeStatic(), event);
+                m_frame_graph->run(FramePhase::UPDATE, delta_time);
             }
             {
                 PROFILE(PostUpdate);
                 sendEvent(PostUpdateEvent::getTypeStatic());
+                m_frame_graph->run(FramePhase::POST_UPDATE, delta_time);
             }
             {
                 PROFILE(Render);
                 sendEvent(RenderEvent::getTypeStatic());
+                m_frame_graph->run(FramePhase::RENDER, delta_time);
                 renderer->getState()->swap();
             }
 
             clock->endFrame();
-            m_context->resetFrameAllocator();
+            m_context->advanceFrameAllocator();
         }
     }
 
@@ -161,6 +199,7 @@ namespace Eris
         Graphics* graphics = m_context->getModule<Graphics>();
         ResourceCache* rc = m_context->getModule<ResourceCache>();
         Clock* clock = m_context->getModule<Clock>();
+        JobSystem* jobs = m_context->getModule<JobSystem>();
         Settings* settings = m_context->getModule<Settings>();
         Renderer* renderer = m_context->getModule<Renderer>();
 
@@ -169,6 +208,7 @@ namespace Eris
 
         renderer->terminate();
         rc->terminate();
+        jobs->terminate();
         graphics->terminate();
 
         glm::f64 duration = clock->getElapsedTime();
@@ -181,6 +221,28 @@ namespace Eris
         Log::raw("Terminating...");
         Log::rawf("\tFrames: %d", frames);
         Log::rawf("\tSeconds: %.2f", duration);
+        m_context->getModule<FrameStats>()->logSummary();
+
+        for (auto& stats : MemoryPoolRegistry::getStats())
+        {
+            if (!stats.name.empty())
+                Log::rawf("\tPool %s: Peak %llu bytes, %llu chunks, %u failed", stats.name.c_str(), (glm::u64) stats.peak_size, (glm::u64) stats.chunks, stats.failed_allocations);
+        }
+
+        for (auto& stats : m_context->getModule<Profiler>()->getLockStats())
+        {
+            Log::rawf("\tLock %s: %llu acquisitions, %llu contended, %llu spins, %llu parked, %.3f ms waiting", stats.name.c_str(),
+                stats.acquisitions, stats.contentions, stats.spins, stats.parks, stats.wait_time * 1000.0);
+        }
+
+        if (AllocationTracker::isEnabled())
+            AllocationTracker::dump();
+
+        if (AllocationTracker::getZeroAllocationViolations())
+        {
+            Log::errorf("Zero allocation mode: %u allocations after frame %llu", AllocationTracker::getZeroAllocationViolations(), m_zero_allocation_frame);
+            setExitCode(EXIT_ALLOCATION_FAILURE);
+        }
     }
 
     const char* Engine::getVersion() const
@@ -193,11 +255,38 @@ namespace Eris
         m_exitcode = exitcode;
     }
 
-    void Engine::handleExitRequest(const StringHash& type, const Event* event)
+    void Engine::handleExitRequest(const ExitRequestedEvent& event)
     {
         m_exiting = true;
     }
 
+    void Engine::handleEndFrame(const EndFrameEvent& event)
+    {
+        MemoryPoolRegistry::endFrame();
+        AllocationTracker::endFrame();
+        s_pool_bytes.set(MemoryPoolRegistry::getUsedSize());
+
+        if (m_pool_frame_report)
+        {
+            Log::rawf("Frame %llu pools:", m_context->getModule<Clock>()->getFrameNumber());
+            for (auto& stats : MemoryPoolRegistry::getFrameReport())
+            {
+                Log::rawf("\tPool %s: %llu used, %llu peak, %u allocations, %u deallocations, %u failed", stats.name.c_str(), (glm::u64) stats.used_size,
+                    (glm::u64) stats.peak_size, stats.frame_allocations, stats.frame_deallocations, stats.frame_failed_allocations);
+            }
+        }
+
+        // Frames up to the configured one are warm up, every frame after it must not touch the heap.
+        if (m_zero_allocation_frame && m_context->getModule<Clock>()->getFrameNumber() == m_zero_allocation_frame)
+            AllocationTracker::setZeroAllocationMode(true);
+
+        if (m_frame_graph_dump_frame && m_context->getModule<Clock>()->getFrameNumber() == m_frame_graph_dump_frame)
+            m_frame_graph->dumpTimings();
+
+        if (m_profile_capture_frame && m_context->getModule<Clock>()->getFrameNumber() == m_profile_capture_frame)
+            m_context->getModule<Profiler>()->capture(m_profile_capture_frames, m_context->getModule<FileSystem>()->getApplicationPreferencesDir() /= "profile.json");
+    }
+
     void Engine::logSystemInfo()
     {
         Log::raw("Initializing...");
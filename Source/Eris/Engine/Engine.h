@@ -27,11 +27,18 @@
 
 namespace Eris
 {
+    class FrameGraph;
+
+    struct EndFrameEvent;
+    struct ExitRequestedEvent;
+
     static const glm::i32 EXIT_OK = 0;
     static const glm::i32 EXIT_INITIALIZATION_FAILURE = 1;
     static const glm::i32 EXIT_GLFW_INIT_ERROR = 2;
     static const glm::i32 EXIT_GLEW_INIT_ERROR = 3;
     static const glm::i32 EXIT_WINDOW_CREATE_ERROR = 4;
+    static const glm::i32 EXIT_ALLOCATION_FAILURE = 5;
+    static const glm::i32 EXIT_TEST_FAILURE = 6;
 
     class Engine : public Object
     {
@@ -46,14 +53,22 @@ namespace Eris
 
         glm::i32 getExitCode() const { return m_exitcode; }
         const char* getVersion() const;
+        FrameGraph* getFrameGraph() const { return m_frame_graph.get(); }
 
     private:
-        void handleExitRequest(const StringHash& type, const Event* event);
+        void handleExitRequest(const ExitRequestedEvent& event);
+        void handleEndFrame(const EndFrameEvent& event);
 
         void logSystemInfo();
 
         bool m_exiting;
+        bool m_pool_frame_report;
         glm::i32 m_exitcode;
+        glm::u64 m_zero_allocation_frame;
+        glm::u64 m_frame_graph_dump_frame;
+        glm::u64 m_profile_capture_frame;
+        glm::u32 m_profile_capture_frames;
+        SharedPtr<FrameGraph> m_frame_graph;
     };
 
     template<> inline void Context::registerModule(Engine* module)
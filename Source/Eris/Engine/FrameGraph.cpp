@@ -0,0 +1,224 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "FrameGraph.h"
+
+#include "Core/Log.h"
+
+#include <algorithm>
+
+namespace Eris
+{
+    static const char* FRAME_PHASE_NAMES[] = { "Update", "PostUpdate", "Render" };
+
+    FrameGraph::FrameGraph(Context* context) :
+        Object(context),
+        m_next_id(1),
+        m_dirty(false),
+        m_time_step(0)
+    {
+        for (auto& start : m_phase_start)
+            start = 0;
+    }
+
+    FrameGraph::~FrameGraph()
+    {
+        for (auto node : m_nodes)
+            delete node;
+    }
+
+    glm::u32 FrameGraph::addSystem(const std::string& name, FramePhase phase, const std::vector<StringHash>& reads, const std::vector<StringHash>& writes, FrameSystemFunction function)
+    {
+        ERIS_ASSERT(phase != FramePhase::COUNT);
+
+        if (!function)
+        {
+            Log::errorf("Frame system %s has no function", name.c_str());
+            return 0;
+        }
+
+        FrameNode* node = new FrameNode();
+        node->id = m_next_id++;
+        node->name = name;
+        node->phase = phase;
+        node->reads = reads;
+        node->writes = writes;
+        node->function = function;
+        node->graph = this;
+        node->predecessors = 0;
+        node->remaining = 0;
+        node->start_time = 0;
+        node->end_time = 0;
+        node->worker = 0;
+
+        m_nodes.push_back(node);
+        m_dirty = true;
+
+        return node->id;
+    }
+
+    void FrameGraph::removeSystem(glm::u32 id)
+    {
+        auto iter = std::find_if(m_nodes.begin(), m_nodes.end(), [id](const FrameNode* node) { return node->id == id; });
+        if (iter == m_nodes.end())
+            return;
+
+        delete *iter;
+        m_nodes.erase(iter);
+        m_dirty = true;
+    }
+
+    void FrameGraph::run(FramePhase phase, glm::f64 time_step)
+    {
+        if (m_dirty)
+            build();
+
+        JobSystem* jobs = m_context->getModule<JobSystem>();
+
+        m_time_step = time_step;
+        m_phase_start[static_cast<std::size_t>(phase)] = glfwGetTime();
+
+        for (auto node : m_nodes)
+        {
+            if (node->phase == phase)
+                node->remaining = node->predecessors;
+        }
+
+        // Successors are scheduled by the nodes they wait on, only the roots are started here.
+        for (auto node : m_nodes)
+        {
+            if (node->phase == phase && !node->predecessors)
+                jobs->schedule(&FrameGraph::runNode, node, &m_counter);
+        }
+
+        jobs->wait(&m_counter);
+    }
+
+    void FrameGraph::dumpTimings() const
+    {
+        for (glm::u32 phase = 0; phase < static_cast<glm::u32>(FramePhase::COUNT); phase++)
+        {
+            glm::f64 phase_start = m_phase_start[phase];
+
+            // Nodes are stored in a topological order, edges always point to a later node.
+            std::unordered_map<const FrameNode*, glm::f64> path_time;
+            std::unordered_map<const FrameNode*, const FrameNode*> path_previous;
+            const FrameNode* critical = nullptr;
+
+            for (auto node : m_nodes)
+            {
+                if (static_cast<glm::u32>(node->phase) != phase)
+                    continue;
+
+                if (!critical)
+                    Log::rawf("Frame graph %s:", FRAME_PHASE_NAMES[phase]);
+
+                glm::f64 duration = node->end_time - node->start_time;
+                Log::rawf("\t%s: start %.3f ms, duration %.3f ms, worker %u", node->name.c_str(), (node->start_time - phase_start) * 1000.0, duration * 1000.0, node->worker);
+
+                path_time[node] += duration;
+                for (auto successor : node->successors)
+                {
+                    if (path_time[node] > path_time[successor])
+                    {
+                        path_time[successor] = path_time[node];
+                        path_previous[successor] = node;
+                    }
+                }
+
+                if (!critical || path_time[node] > path_time[critical])
+                    critical = node;
+            }
+
+            if (!critical)
+                continue;
+
+            std::string path = critical->name;
+            for (auto iter = path_previous.find(critical); iter != path_previous.end(); iter = path_previous.find(iter->second))
+                path = iter->second->name + " -> " + path;
+
+            Log::rawf("\tCritical path %.3f ms: %s", path_time[critical] * 1000.0, path.c_str());
+        }
+    }
+
+    void FrameGraph::build()
+    {
+        for (auto node : m_nodes)
+        {
+            node->successors.clear();
+            node->predecessors = 0;
+        }
+
+        for (std::size_t i = 0; i < m_nodes.size(); i++)
+        {
+            for (std::size_t j = i + 1; j < m_nodes.size(); j++)
+            {
+                FrameNode* first = m_nodes[i];
+                FrameNode* second = m_nodes[j];
+                if (first->phase == second->phase && conflicts(first, second))
+                {
+                    first->successors.push_back(second);
+                    second->predecessors++;
+                }
+            }
+        }
+
+        m_dirty = false;
+    }
+
+    bool FrameGraph::conflicts(const FrameNode* first, const FrameNode* second)
+    {
+        for (auto& resource : first->writes)
+        {
+            if (std::find(second->reads.begin(), second->reads.end(), resource) != second->reads.end() ||
+                std::find(second->writes.begin(), second->writes.end(), resource) != second->writes.end())
+                return true;
+        }
+
+        for (auto& resource : second->writes)
+        {
+            if (std::find(first->reads.begin(), first->reads.end(), resource) != first->reads.end())
+                return true;
+        }
+
+        return false;
+    }
+
+    void FrameGraph::runNode(void* data, glm::u32 begin, glm::u32 end)
+    {
+        FrameNode* node = static_cast<FrameNode*>(data);
+        FrameGraph* graph = node->graph;
+
+        node->worker = JobSystem::getWorkerIndex();
+        node->start_time = glfwGetTime();
+        node->function(graph->m_time_step);
+        node->end_time = glfwGetTime();
+
+        // Scheduled before this job finishes, so the phase counter cannot reach zero in between.
+        JobSystem* jobs = graph->m_context->getModule<JobSystem>();
+        for (auto successor : node->successors)
+        {
+            if (--successor->remaining == 0)
+                jobs->schedule(&FrameGraph::runNode, successor, &graph->m_counter);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Collections/StringHash.h"
+#include "Core/Context.h"
+#include "Core/Object.h"
+#include "Thread/JobSystem.h"
+
+#include <functional>
+#include <vector>
+
+namespace Eris
+{
+    enum class FramePhase : glm::u8
+    {
+        UPDATE,
+        POST_UPDATE,
+        RENDER,
+        COUNT
+    };
+
+    using FrameSystemFunction = std::function < void(glm::f64 time_step) > ;
+
+    /// Runs the systems of a frame phase on the job system. Systems declare the resources they read and write, two
+    /// systems of the same phase only run concurrently when neither writes what the other one touches, otherwise
+    /// they keep the order they were added in.
+    class FrameGraph : public Object
+    {
+    public:
+        FrameGraph(Context* context);
+        ~FrameGraph();
+
+        /// The function runs on any job worker, concurrently with the other systems of its phase. It must not call
+        /// sendEvent or subscribe and unsubscribe, event dispatch is main thread only. Use postEvent to reach other systems.
+        glm::u32 addSystem(const std::string& name, FramePhase phase, const std::vector<StringHash>& reads, const std::vector<StringHash>& writes, FrameSystemFunction function);
+        void removeSystem(glm::u32 id);
+
+        void run(FramePhase phase, glm::f64 time_step);
+
+        /// Logs when every system of the last frame started and how long it took, followed by the critical path of each phase.
+        void dumpTimings() const;
+
+    private:
+        struct FrameNode
+        {
+            glm::u32 id;
+            std::string name;
+            FramePhase phase;
+            std::vector<StringHash> reads;
+            std::vector<StringHash> writes;
+            FrameSystemFunction function;
+
+            FrameGraph* graph;
+            std::vector<FrameNode*> successors;
+            glm::u32 predecessors;
+            std::atomic<glm::u32> remaining;
+
+            glm::f64 start_time;
+            glm::f64 end_time;
+            glm::u32 worker;
+        };
+
+        void build();
+        static bool conflicts(const FrameNode* first, const FrameNode* second);
+        static void runNode(void* data, glm::u32 begin, glm::u32 end);
+
+        std::vector<FrameNode*> m_nodes;
+        glm::u32 m_next_id;
+        bool m_dirty;
+
+        JobCounter m_counter;
+        glm::f64 m_time_step;
+        glm::f64 m_phase_start[static_cast<std::size_t>(FramePhase::COUNT)];
+    };
+}
\ No newline at end of file
@@ -164,25 +164,28 @@ namespace Eris
 
     void Material::setUniform(const std::string& uniform, const Variant& data)
     {
-        if (m_parameters.find(uniform) != m_parameters.end())
-            m_parameters[uniform].data = data;
+        StringHash hash = STRING_HASH(uniform.c_str());
+
+        auto find = m_parameters.find(hash);
+        if (find != m_parameters.end())
+            find->second.data = data;
         else
         {
-            ShaderUniform* shader_uniform = m_program->getUniform(uniform);
+            ShaderUniform* shader_uniform = m_program->getUniform(hash);
             if (shader_uniform)
             {
                 ShaderUniform material_uniform;
                 material_uniform.location = shader_uniform->location;
                 material_uniform.type = shader_uniform->type;
                 material_uniform.data = data;
-                m_parameters[uniform] = material_uniform;
+                m_parameters[hash] = material_uniform;
             }
             else
                 Log::warnf("Attempting to set undefined uniform %s in material %s", uniform, getName());
         }
     }
 
-    ShaderUniform* Material::getUniform(std::string uniform)
+    ShaderUniform* Material::getUniform(const StringHash& uniform)
     {
         auto find = m_parameters.find(uniform);
         if (find != m_parameters.end())
@@ -190,7 +193,7 @@ namespace Eris
         return nullptr;
     }
 
-    void Material::removeUniform(std::string uniform)
+    void Material::removeUniform(const StringHash& uniform)
     {
         m_parameters.erase(uniform);
     }
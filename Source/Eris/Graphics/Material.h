@@ -66,15 +66,15 @@ namespace Eris
         void setCullMode(CullMode mode);
 
         void setUniform(const std::string& uniform, const Variant& data);
-        ShaderUniform* getUniform(std::string uniform);
-        void removeUniform(std::string uniform);
+        ShaderUniform* getUniform(const StringHash& uniform);
+        void removeUniform(const StringHash& uniform);
 
     private:
         glm::u64 m_render_key;
         CullMode m_cull_mode;
         SharedPtr<ShaderProgram> m_program;
         TextureUnit m_textures[32];
-        std::map<std::string, ShaderUniform> m_parameters;
+        std::unordered_map<StringHash, ShaderUniform> m_parameters;
         std::vector<StringHash> m_tags;
 
         static boost::uuids::random_generator s_uuid_generator;
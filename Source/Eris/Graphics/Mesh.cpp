@@ -23,8 +23,12 @@
 #include "Graphics.h"
 #include "Mesh.h"
 
+#include "Core/Profiler.h"
+
 namespace Eris
 {
+    static ProfilerCounter s_draw_calls("DrawCalls");
+
 
 
     Mesh::Mesh(Context* context) : 
@@ -62,6 +66,7 @@ namespace Eris
 
         glBindVertexArray(m_vao);
         glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
+        s_draw_calls.add();
         glBindVertexArray(0);
     }
 
@@ -100,14 +105,14 @@ namespace Eris
         glfwMakeContextCurrent(win);
     }
 
-    void Mesh::setVertices(std::vector<Vertex> vertices)
+    void Mesh::setVertices(VertexList vertices)
     {
-        m_vertices = vertices;
+        m_vertices = std::move(vertices);
     }
 
-    void Mesh::setIndices(std::vector<glm::u32> indices)
+    void Mesh::setIndices(IndexList indices)
     {
-        m_indices = indices;
+        m_indices = std::move(indices);
     }
 
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 
 #include "Core/Context.h"
 #include "Core/Object.h"
+#include "Memory/Allocator.h"
 
 namespace Eris
 {
@@ -41,6 +42,9 @@ namespace Eris
         glm::vec2 texcoords;
     };
 
+    using VertexList = std::vector<Vertex, TlsfAllocator<Vertex>>;
+    using IndexList = std::vector<glm::u32, TlsfAllocator<glm::u32>>;
+
     class Mesh : public Object
     {
     public:
@@ -49,21 +53,21 @@ namespace Eris
         void draw();
         void compile();
 
-        void setVertices(std::vector<Vertex> vertices);
-        void setIndices(std::vector<glm::u32> indices);
+        void setVertices(VertexList vertices);
+        void setIndices(IndexList indices);
 
         glm::u32 getVao() const { return m_vao; }
         glm::u32 getVbo() const { return m_vbo; }
         glm::u32 getEbo() const { return m_ebo; }
-        std::vector<glm::u32> getIndices() const { return m_indices; }
-        std::vector<Vertex> getVertices() const { return m_vertices; }
+        const IndexList& getIndices() const { return m_indices; }
+        const VertexList& getVertices() const { return m_vertices; }
 
     private:
         GenerationState m_gen_state;
         glm::u32 m_vao;
         glm::u32 m_vbo;
         glm::u32 m_ebo;
-        std::vector<glm::u32> m_indices;
-        std::vector<Vertex> m_vertices;
+        IndexList m_indices;
+        VertexList m_vertices;
     };
 }
\ No newline at end of file
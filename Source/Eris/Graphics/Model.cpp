@@ -25,7 +25,7 @@
 
 #include "Core/Log.h"
 #include "Core/Profiler.h"
-#include "Memory/ArrayPointers.h"
+#include "Memory/Scratch.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -47,15 +47,21 @@ namespace Eris
 
         std::size_t ds_size = deserializer.getSize();
 
-        SharedArrayPtr<char> buffer = SharedArrayPtr<char>(ds_size + 1);
-        std::size_t in_size = deserializer.read(buffer.get(), ds_size);
+        ScratchScope scratch;
+        char* buffer = scratch.allocateArray<char>(ds_size + 1);
+        if (!buffer)
+            return false;
+
+        std::size_t in_size = deserializer.read(buffer, ds_size);
 
         if (in_size != ds_size)
             return false;
 
+        buffer[ds_size] = '\0';
+
         Assimp::Importer importer;
 
-        const aiScene* scene = importer.ReadFileFromMemory(buffer.get(), ds_size, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_FixInfacingNormals | aiProcess_GenUVCoords | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeGraph | aiProcess_OptimizeMeshes);
+        const aiScene* scene = importer.ReadFileFromMemory(buffer, ds_size, aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_FixInfacingNormals | aiProcess_GenUVCoords | aiProcess_JoinIdenticalVertices | aiProcess_OptimizeGraph | aiProcess_OptimizeMeshes);
 
         if (!scene || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
         {
@@ -72,7 +78,8 @@ namespace Eris
         for (auto i = 0U; i < scene->mNumMeshes; i++)
         {
             aiMesh* aimesh = scene->mMeshes[i];
-            std::vector<Vertex> vertices;
+            VertexList vertices;
+            vertices.reserve(aimesh->mNumVertices);
             for (auto j = 0U; j < aimesh->mNumVertices; j++)
             {
                 Vertex vertex;
@@ -96,7 +103,8 @@ namespace Eris
                 vertices.push_back(vertex);
             }
 
-            std::vector<glm::u32> indices;
+            IndexList indices;
+            indices.reserve(aimesh->mNumFaces * 3);
             for (auto j = 0U; j < aimesh->mNumFaces; j++)
             {
                 aiFace face = aimesh->mFaces[j];
@@ -105,8 +113,8 @@ namespace Eris
             }
 
             SharedPtr<Mesh> mesh = SharedPtr<Mesh>(new Mesh(m_context));
-            mesh->setVertices(vertices);
-            mesh->setIndices(indices);
+            mesh->setVertices(std::move(vertices));
+            mesh->setIndices(std::move(indices));
             m_meshes.push_back(mesh);
         }
 
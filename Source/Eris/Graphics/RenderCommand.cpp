@@ -27,6 +27,9 @@
 
 namespace Eris
 {
+    static const StringHash UNIFORM_VIEW("view");
+    static const StringHash UNIFORM_PERSPECTIVE("perspective");
+
     glm::u64 RenderKey::operator()()
     {
         if (transparency)
@@ -75,12 +78,12 @@ namespace Eris
 
     void Draw3DCommand::operator()(Renderer* renderer, const RenderKey* last_key)
     {
-        AutoProfilerBlock profile(renderer->getContext()->getModule<Profiler>(), "Draw3DCommand");
+        PROFILE(Draw3DCommand);
 
         if ( !last_key || last_key->material != key.material )
         {
-            material->getUniform( "view" )->data = renderer->getCurrentView();
-            material->getUniform( "perspective" )->data = renderer->getCurrentPerspective();
+            material->getUniform(UNIFORM_VIEW)->data = renderer->getCurrentView();
+            material->getUniform(UNIFORM_PERSPECTIVE)->data = renderer->getCurrentPerspective();
             material->use();
         }
 
@@ -24,10 +24,12 @@
 #include "RenderQueue.h"
 
 #include "Core/Profiler.h"
-#include "Thread/SpinLock.h"
+#include "Thread/TicketLock.h"
 
 namespace Eris
 {
+    static ProfilerCounter s_render_commands("RenderCommands");
+
     struct RenderQueueSorter
     {
         bool operator () (SharedPtr<RenderCommand>& lhs, SharedPtr<RenderCommand>& rhs)
@@ -39,28 +41,44 @@ namespace Eris
     RenderQueue::RenderQueue(Context* context) :
         Object(context)
     {
+        // The render thread processes the queue while the main thread sorts and clears the others, neither may starve the other.
+        m_lock.setName("RenderQueue");
+    }
+
+    RenderQueue::~RenderQueue()
+    {
+        clear();
     }
 
     void RenderQueue::add(RenderCommand* item)
     {
-        std::lock_guard<SpinLock> lock(m_lock);
         if (!item->key.key)
             item->key();
 
+        s_render_commands.add();
+
+        // The queued pointer holds its own reference, the caller may let go of the command before the next drain.
+        item->increment();
+        if (m_pending.push(item))
+            return;
+
+        std::lock_guard<TicketLock> lock(m_lock);
         m_commands.push_back(SharedPtr<RenderCommand>(item));
+        item->release();
     }
 
     void RenderQueue::sort()
     {
         PROFILE(SortQueue);
-        std::lock_guard<SpinLock> lock(m_lock);
+        std::lock_guard<TicketLock> lock(m_lock);
+        drain();
         std::sort(m_commands.begin(), m_commands.end(), RenderQueueSorter());
     }
 
     void RenderQueue::process()
     {
         PROFILE(ProcessQueue);
-        std::lock_guard<SpinLock> lock(m_lock);
+        std::lock_guard<TicketLock> lock(m_lock);
         if (m_commands.empty())
             return;
 
@@ -78,8 +96,19 @@ namespace Eris
 
     void RenderQueue::clear()
     {
-        std::lock_guard<SpinLock> lock(m_lock);
+        std::lock_guard<TicketLock> lock(m_lock);
+        drain();
         m_commands.clear();
     }
 
+    void RenderQueue::drain()
+    {
+        RenderCommand* item;
+        while (m_pending.pop(item))
+        {
+            m_commands.push_back(SharedPtr<RenderCommand>(item));
+            item->release();
+        }
+    }
+
 }
\ No newline at end of file
@@ -27,14 +27,18 @@
 #include "Core/Context.h"
 #include "Core/Object.h"
 #include "Memory/Pointers.h"
-#include "Thread/SpinLock.h"
+#include "Thread/MpmcQueue.h"
+#include "Thread/TicketLock.h"
 
 namespace Eris
 {
+    static const glm::u32 RENDER_QUEUE_CAPACITY = 8192;
+
     class RenderQueue : public Object
     {
     public:
         RenderQueue(Context* context);
+        ~RenderQueue();
 
         void add(RenderCommand* item);
         void sort();
@@ -42,7 +46,11 @@ namespace Eris
         void clear();
 
     private:
-        SpinLock m_lock;
+        void drain();
+
+        /// Commands added since the last sort, each holding a reference. Producers never take the lock unless it overflows.
+        MpmcQueue<RenderCommand*, RENDER_QUEUE_CAPACITY> m_pending;
+        TicketLock m_lock;
         std::vector<SharedPtr<RenderCommand>> m_commands;
     };
 }
\ No newline at end of file
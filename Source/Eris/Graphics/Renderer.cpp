@@ -38,7 +38,7 @@ namespace Eris
         m_initialized(false),
         m_state(new RenderState(context))
     {
-        subscribeToEvent(ScreenModeEvent::getTypeStatic(), HANDLER(Renderer, handleScreenMode));
+        subscribe<ScreenModeEvent, Renderer, &Renderer::handleScreenMode>(this);
     }
 
     Renderer::~Renderer()
@@ -55,13 +55,14 @@ namespace Eris
         if (m_initialized)
             return;
 
-        subscribeToEvent(RenderEvent::getTypeStatic(), HANDLER(Renderer, handleRender));
+        subscribe<RenderEvent, Renderer, &Renderer::handleRender>(this);
         m_thread = std::thread(&Renderer::run, this);
     }
 
     void Renderer::run()
     {
         Log::infof("Rendered Thread started: %d", std::this_thread::get_id().hash());
+        Profiler::setThreadName("Renderer");
 
         Clock* clock = m_context->getModule<Clock>();
         Graphics* graphics = m_context->getModule<Graphics>();
@@ -235,12 +236,12 @@ namespace Eris
         return true;
     }
 
-    void Renderer::handleScreenMode(const StringHash& type, const Event* event)
+    void Renderer::handleScreenMode(const ScreenModeEvent& event)
     {
         m_viewport_dirty = true;
     }
 
-    void Renderer::handleRender(const StringHash& type, const Event* event)
+    void Renderer::handleRender(const RenderEvent& event)
     {
         ClearColorCommand* clear_color_command = new ClearColorCommand();
         clear_color_command->key.command = 0;
@@ -30,6 +30,9 @@
 
 namespace Eris
 {
+    struct RenderEvent;
+    struct ScreenModeEvent;
+
     class Renderer : public Object
     {
     public:
@@ -58,8 +61,8 @@ namespace Eris
     private:
         bool initializeOpenGL(GLFWwindow* window, glm::i32 width, glm::i32 height);
 
-        void handleScreenMode(const StringHash& type, const Event* event);
-        void handleRender(const StringHash& type, const Event* event);
+        void handleScreenMode(const ScreenModeEvent& event);
+        void handleRender(const RenderEvent& event);
 
         bool m_initialized;
         std::thread m_thread;
@@ -101,11 +101,12 @@ namespace Eris
 
     void ShaderProgram::setUniform(const std::string& uniform, const Variant& data)
     {
-        if (m_parameters.find(uniform) != m_parameters.end())
-            m_parameters[uniform].data = data;
+        auto find = m_parameters.find(uniform);
+        if (find != m_parameters.end())
+            find->second.data = data;
     }
 
-    ShaderUniform* ShaderProgram::getUniform(std::string uniform)
+    ShaderUniform* ShaderProgram::getUniform(const StringHash& uniform)
     {
         auto find = m_parameters.find(uniform);
         if (find != m_parameters.end())
@@ -113,7 +114,7 @@ namespace Eris
         return nullptr;
     }
 
-    void ShaderProgram::removeUniform(std::string uniform)
+    void ShaderProgram::removeUniform(const StringHash& uniform)
     {
         m_parameters.erase(uniform);
     }
@@ -203,7 +204,7 @@ namespace Eris
             ShaderUniform parameter;
             parameter.type = type;
             parameter.location = i;
-            m_parameters[name] = parameter;
+            m_parameters[STRING_HASH(name)] = parameter;
         }
 
         glfwMakeContextCurrent(win);
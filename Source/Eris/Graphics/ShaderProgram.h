@@ -59,8 +59,8 @@ namespace Eris
         void use() const;
 
         void setUniform(const std::string& uniform, const Variant& data);
-        ShaderUniform* getUniform(std::string uniform);
-        void removeUniform(std::string uniform);
+        ShaderUniform* getUniform(const StringHash& uniform);
+        void removeUniform(const StringHash& uniform);
 
         glm::u32 getHandle() const { return m_handle; }
 
@@ -68,6 +68,6 @@ namespace Eris
         bool compile(const char* vert_source, const char* frag_source);
 
         glm::u32 m_handle;
-        std::map<std::string, ShaderUniform> m_parameters;
+        std::unordered_map<StringHash, ShaderUniform> m_parameters;
     };
 }
\ No newline at end of file
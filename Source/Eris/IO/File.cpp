@@ -24,9 +24,12 @@
 #include "FileSystem.h"
 
 #include "Core/Log.h"
+#include "Core/Profiler.h"
 
 namespace Eris
 {
+    static ProfilerCounter s_bytes_read("FileBytesRead");
+
 
     File::File(Context* context) :
         Object(context),
@@ -146,6 +149,7 @@ namespace Eris
         if (m_handle.is_open())
         {
             m_handle.read((char *) buffer, count);
+            s_bytes_read.add(m_handle.gcount());
             return m_handle.gcount();
         }
 
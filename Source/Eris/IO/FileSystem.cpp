@@ -30,8 +30,10 @@ namespace Eris
 {
     FileSystem::FileSystem(Context* context) : 
         Object(context),
-        m_allowed_paths(ChainAllocator<Path>(0, sizeof(Path), 128 * sizeof(Path)))
+        m_paths_pool(new ChainMemoryPool(sizeof(Path), 128 * sizeof(Path))),
+        m_allowed_paths(ChainAllocator<Path>(m_paths_pool.get()))
     {
+        m_paths_pool->setName("FileSystem/AllowedPaths");
     }
 
     void FileSystem::addPath(const Path& path)
@@ -26,6 +26,8 @@
 #include "Core/Object.h"
 #include "Memory/Allocator.h"
 
+#include <unordered_set>
+
 namespace Eris
 {
     static const glm::uint SCAN_FILES = 1;
@@ -58,6 +60,7 @@ namespace Eris
         Path getApplicationPreferencesDir() const;
 
     private:
+        SharedPtr<ChainMemoryPool> m_paths_pool;
         std::unordered_set<Path, std::hash<Path>, std::equal_to<Path>, ChainAllocator<Path>> m_allowed_paths;
     };
 
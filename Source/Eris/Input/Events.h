@@ -54,6 +54,14 @@ namespace Eris
         double amount;
         glm::int32 buttons;
         glm::int32 modifiers;
+
+        virtual void coalesce(const Event& newer)
+        {
+            const MouseScrollEvent& scroll = static_cast<const MouseScrollEvent&>(newer);
+            amount += scroll.amount;
+            buttons = scroll.buttons;
+            modifiers = scroll.modifiers;
+        }
     };
 
     struct MouseMoveEvent : public Event
@@ -65,6 +73,15 @@ namespace Eris
         glm::ivec2 relative;
         glm::int32 buttons;
         glm::int32 modifiers;
+
+        virtual void coalesce(const Event& newer)
+        {
+            const MouseMoveEvent& move = static_cast<const MouseMoveEvent&>(newer);
+            position = move.position;
+            relative += move.relative;
+            buttons = move.buttons;
+            modifiers = move.modifiers;
+        }
     };
 
     struct KeyPressEvent : public Event
@@ -39,11 +39,13 @@ namespace Eris
         m_cursor_mode(CursorMode::CM_NORMAL),
         m_focused(false),
         m_minimized(false),
-        m_key_down(ChainAllocator<glm::i32>(0, 8 * sizeof(glm::i32), 128 * sizeof(glm::i32))),
-        m_key_press(ChainAllocator<glm::i32>(0, 8 * sizeof(glm::i32), 128 * sizeof(glm::i32))),
-        m_scancode_down(ChainAllocator<glm::i32>(0, 8 * sizeof(glm::i32), 128 * sizeof(glm::i32))),
-        m_scancode_press(ChainAllocator<glm::i32>(0, 8 * sizeof(glm::i32), 128 * sizeof(glm::i32)))
+        m_keys_pool(new ChainMemoryPool(8 * sizeof(glm::i32), 128 * sizeof(glm::i32))),
+        m_key_down(ChainAllocator<glm::i32>(m_keys_pool.get())),
+        m_key_press(ChainAllocator<glm::i32>(m_keys_pool.get())),
+        m_scancode_down(ChainAllocator<glm::i32>(m_keys_pool.get())),
+        m_scancode_press(ChainAllocator<glm::i32>(m_keys_pool.get()))
     {
+        m_keys_pool->setName("Input/Keys");
     }
 
     void Input::update()
@@ -156,8 +158,12 @@ namespace Eris
 
         Graphics* graphics = m_context->getModule<Graphics>();
 
-        subscribeToEvent(BeginFrameEvent::getTypeStatic(), HANDLER(Input, handleBeginFrame));
-        subscribeToEvent(ScreenModeEvent::getTypeStatic(), HANDLER(Input, handleScreenMode));
+        subscribe<BeginFrameEvent, Input, &Input::handleBeginFrame>(this);
+        subscribe<ScreenModeEvent, Input, &Input::handleScreenMode>(this);
+
+        // A high polling rate mouse reports many times per frame, subscribers only see one event per frame.
+        m_context->setEventCoalescing(MouseMoveEvent::getTypeStatic(), EventCoalescing::ACCUMULATE);
+        m_context->setEventCoalescing(MouseScrollEvent::getTypeStatic(), EventCoalescing::ACCUMULATE);
 
         GLFWwindow* window = graphics->getWindow();
         if (!window)
@@ -191,7 +197,7 @@ namespace Eris
         m_mouse_button_down = 0;
     }
 
-    void Input::handleScreenMode(const StringHash& event_type, const Event* event_data)
+    void Input::handleScreenMode(const ScreenModeEvent& event)
     {
         if (!m_initialised)
             initialize();
@@ -204,7 +210,7 @@ namespace Eris
         m_minimized = glfwGetWindowAttrib(window, GLFW_ICONIFIED) == GL_TRUE;
     }
 
-    void Input::handleBeginFrame(const StringHash& event_type, const Event* event_data)
+    void Input::handleBeginFrame(const BeginFrameEvent& event)
     {
         update();
     }
@@ -239,7 +245,7 @@ namespace Eris
             event->button = button;
             event->buttons = input->m_mouse_button_down;
             event->modifiers = mods;
-            input->sendEvent(MouseButtonPressEvent::getTypeStatic(), event);
+            input->bufferEvent(MouseButtonPressEvent::getTypeStatic(), event);
         }
         else
         {
@@ -249,7 +255,7 @@ namespace Eris
             event->button = button;
             event->buttons = input->m_mouse_button_down;
             event->modifiers = mods;
-            input->sendEvent(MouseButtonReleaseEvent::getTypeStatic(), event);
+            input->bufferEvent(MouseButtonReleaseEvent::getTypeStatic(), event);
         }
     }
 
@@ -271,7 +277,7 @@ namespace Eris
             event->buttons = input->m_mouse_button_down;
             event->modifiers = mods;
             event->repeat = false;
-            input->sendEvent(KeyPressEvent::getTypeStatic(), event);
+            input->bufferEvent(KeyPressEvent::getTypeStatic(), event);
         }
         else if (action == GLFW_REPEAT)
         {
@@ -286,7 +292,7 @@ namespace Eris
             event->buttons = input->m_mouse_button_down;
             event->modifiers = mods;
             event->repeat = true;
-            input->sendEvent(KeyPressEvent::getTypeStatic(), event);
+            input->bufferEvent(KeyPressEvent::getTypeStatic(), event);
         }
         else
         {
@@ -298,7 +304,7 @@ namespace Eris
             event->scancode = scancode;
             event->buttons = input->m_mouse_button_down;
             event->modifiers = mods;
-            input->sendEvent(KeyPressEvent::getTypeStatic(), event);
+            input->bufferEvent(KeyPressEvent::getTypeStatic(), event);
         }
     }
 
@@ -315,7 +321,7 @@ namespace Eris
         event->amount = amount;
         event->buttons = input->m_mouse_button_down;
         event->modifiers = input->getModifiersDown();
-        input->sendEvent(MouseScrollEvent::getTypeStatic(), event);
+        input->bufferEvent(MouseScrollEvent::getTypeStatic(), event);
     }
 
     void Input::handleCursorPosCallback(GLFWwindow* window, double x, double y)
@@ -334,7 +340,7 @@ namespace Eris
         event->relative = relative;
         event->buttons = input->m_mouse_button_down;
         event->modifiers = input->getModifiersDown();
-        input->sendEvent(MouseMoveEvent::getTypeStatic(), event);
+        input->bufferEvent(MouseMoveEvent::getTypeStatic(), event);
     }
 
 }
\ No newline at end of file
@@ -32,6 +32,9 @@ namespace Eris
 {
     class Graphics;
 
+    struct BeginFrameEvent;
+    struct ScreenModeEvent;
+
     enum class CursorMode : glm::u8
     {
         CM_NORMAL,
@@ -65,8 +68,8 @@ namespace Eris
         bool minimized() const { return m_minimized; }
 
     private:
-        void handleBeginFrame(const StringHash& event_type, const Event* event_data);
-        void handleScreenMode(const StringHash& event_type, const Event* event_data);
+        void handleBeginFrame(const BeginFrameEvent& event);
+        void handleScreenMode(const ScreenModeEvent& event);
 
         static void handleFocusCallback(GLFWwindow* window, int focused);
         static void handleIconifiedCallback(GLFWwindow* window, int iconified);
@@ -84,6 +87,7 @@ namespace Eris
         double m_mouse_wheel_move;        
         glm::ivec2 m_mouse_move;
         glm::ivec2 m_mouse_last_position;
+        SharedPtr<ChainMemoryPool> m_keys_pool;
         std::unordered_set<glm::int32, std::hash<glm::int32>, std::equal_to<glm::i32>, ChainAllocator<glm::i32>> m_key_down;
         std::unordered_set<glm::int32, std::hash<glm::int32>, std::equal_to<glm::i32>, ChainAllocator<glm::i32>> m_key_press;
         std::unordered_set<glm::int32, std::hash<glm::int32>, std::equal_to<glm::i32>, ChainAllocator<glm::i32>> m_scancode_down;
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <intrin.h>
+
 namespace Eris
 {
     template<typename Number = glm::i32>
@@ -29,4 +31,16 @@ namespace Eris
     {
         return (x != 0) && ((x & (x - 1)) == 0);
     }
+
+    inline glm::i32 findFirstSet(glm::u32 x)
+    {
+        unsigned long index;
+        return _BitScanForward(&index, x) ? static_cast<glm::i32>(index) : -1;
+    }
+
+    inline glm::i32 findLastSet(glm::u64 x)
+    {
+        unsigned long index;
+        return _BitScanReverse64(&index, x) ? static_cast<glm::i32>(index) : -1;
+    }
 }
\ No newline at end of file
@@ -54,41 +54,32 @@ namespace Eris
         };
 
     public:
-        GenericPoolAllocator();
-
-        GenericPoolAllocator(const GenericPoolAllocator& rhs)
+        GenericPoolAllocator() :
+            m_handle(TPool::getDefault()->getHandle())
         {
-            copy(rhs);
         }
 
         template<typename Y>
-        GenericPoolAllocator(const GenericPoolAllocator<Y, TPool>& rhs)
-        {
-            copy(rhs);
-        }
-
-        template<typename... TArgs>
-        explicit GenericPoolAllocator(std::size_t initial, TArgs&&... args) :
-            m_pool(new TPool(std::forward<TArgs>(args)...))
+        GenericPoolAllocator(const GenericPoolAllocator<Y, TPool>& rhs) :
+            m_handle(rhs.m_handle)
         {
         }
 
-        ~GenericPoolAllocator()
+        explicit GenericPoolAllocator(TPool* pool) :
+            m_handle(pool->getHandle())
         {
-            clear();
         }
 
-        GenericPoolAllocator& operator = (const GenericPoolAllocator& rhs)
+        template<typename Y>
+        bool operator == (const GenericPoolAllocator<Y, TPool>& rhs) const
         {
-            copy(rhs);
-            return *this;
+            return m_handle == rhs.m_handle;
         }
 
         template<typename Y>
-        GenericPoolAllocator& operator = (const GenericPoolAllocator<Y, TPool>& rhs)
+        bool operator != (const GenericPoolAllocator<Y, TPool>& rhs) const
         {
-            copy(rhs);
-            return *this;
+            return m_handle != rhs.m_handle;
         }
 
         pointer address(reference ref) const
@@ -105,9 +96,7 @@ namespace Eris
         {
             (void) hint;
 
-            size_type size = n * sizeof(value_type);
-            std::size_t alignment = hint ? *reinterpret_cast<const std::size_t*>(hint) : __alignof(value_type);
-            void* out = m_pool->allocate(size, alignment);
+            void* out = getMemoryPool().allocate(n * sizeof(value_type), __alignof(value_type));
 
             return reinterpret_cast<pointer>(out);
         }
@@ -115,7 +104,7 @@ namespace Eris
         void deallocate(void* p, size_type n)
         {
             (void) n;
-            m_pool->deallocate(p);
+            getMemoryPool().deallocate(p);
         }
 
         void construct(pointer p, const T& val)
@@ -147,16 +136,9 @@ namespace Eris
             return std::numeric_limits<std::size_t>::max();
         }
 
-        const TPool& getMemoryPool() const
+        TPool& getMemoryPool() const
         {
-            ERIS_ASSERT(m_pool);
-            return *m_pool;
-        }
-
-        TPool& getMemoryPool()
-        {
-            ERIS_ASSERT(m_pool);
-            return *m_pool;
+            return *static_cast<TPool*>(MemoryPoolRegistry::getPool(m_handle));
         }
 
         template<typename K, typename... Args>
@@ -241,26 +223,8 @@ namespace Eris
         }
 
     private:
-        template<typename Y>
-        void copy(const GenericPoolAllocator<Y, TPool>& rhs)
-        {
-            clear();
-            if (rhs.m_pool)
-            {
-                m_pool = rhs.m_pool;
-            }
-        }
-
-        void clear()
-        {
-            if (m_pool)
-            {
-                m_pool.reset();
-                m_pool = nullptr;
-            }
-        }
-
-        SharedPtr<TPool> m_pool;
+        /// Index into the MemoryPoolRegistry, the allocator does not own the pool so the owner must outlive any container using it.
+        glm::u32 m_handle;
     };
 
     template<typename T>
@@ -274,4 +238,15 @@ namespace Eris
 
     template<typename T>
     using ChainAllocator = GenericPoolAllocator<T, ChainMemoryPool> ;
+
+    static_assert(sizeof(ChainAllocator<int>) <= sizeof(void*), "Pool allocators must stay handle sized");
+
+    template<typename T>
+    using FrameAllocator = GenericPoolAllocator<T, FrameMemoryPool>;
+
+    template<typename T>
+    using SlabAllocator = GenericPoolAllocator<T, SlabMemoryPool>;
+
+    template<typename T>
+    using TlsfAllocator = GenericPoolAllocator<T, TlsfMemoryPool>;
 }
\ No newline at end of file
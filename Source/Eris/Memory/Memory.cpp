@@ -22,18 +22,52 @@
 
 #include "Functions.h"
 #include "Memory.h"
+#include "Tracking.h"
 
 #include "Core/Log.h"
+#include "Thread/Functions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
 
 namespace Eris
 {
+    namespace
+    {
+        struct Registry
+        {
+            SpinLock lock;
+            std::vector<BaseMemoryPool::Stats> report;
+            bool exit_callback = false;
+        };
+
+        Registry& getRegistry()
+        {
+            static Registry s_registry;
+            return s_registry;
+        }
+    }
 
     BaseMemoryPool::BaseMemoryPool(Type type) :
         RefCounted(),
         NonCopyable(),
         m_type(type),
-        m_allocations(0)
+        m_allocations(0),
+        m_used_size(0),
+        m_peak_size(0),
+        m_chunks(0),
+        m_frame_allocations(0),
+        m_frame_deallocations(0),
+        m_frame_failed_allocations(0),
+        m_failed_allocations(0)
+    {
+        m_handle = MemoryPoolRegistry::add(this);
+    }
+
+    BaseMemoryPool::~BaseMemoryPool()
     {
+        MemoryPoolRegistry::remove(this);
     }
 
     void* BaseMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
@@ -50,6 +84,15 @@ namespace Eris
         case Type::CHAIN:
             out = static_cast<ChainMemoryPool*>(this)->allocate(size, alignment_bits);
             break;
+        case Type::FRAME:
+            out = static_cast<FrameMemoryPool*>(this)->allocate(size, alignment_bits);
+            break;
+        case Type::SLAB:
+            out = static_cast<SlabMemoryPool*>(this)->allocate(size, alignment_bits);
+            break;
+        case Type::TLSF:
+            out = static_cast<TlsfMemoryPool*>(this)->allocate(size, alignment_bits);
+            break;
         default:
             ERIS_ASSERT(0);
         }
@@ -70,11 +113,194 @@ namespace Eris
         case Type::CHAIN:
             static_cast<ChainMemoryPool*>(this)->deallocate(ptr);
             break;
+        case Type::FRAME:
+            static_cast<FrameMemoryPool*>(this)->deallocate(ptr);
+            break;
+        case Type::SLAB:
+            static_cast<SlabMemoryPool*>(this)->deallocate(ptr);
+            break;
+        case Type::TLSF:
+            static_cast<TlsfMemoryPool*>(this)->deallocate(ptr);
+            break;
         default:
             ERIS_ASSERT(0);
         }
     }
 
+    BaseMemoryPool::Stats BaseMemoryPool::getStats() const
+    {
+        Stats stats;
+        stats.name = m_name;
+        stats.type = m_type;
+        stats.used_size = m_used_size.load();
+        stats.peak_size = m_peak_size.load();
+        stats.chunks = m_chunks.load();
+        stats.allocations = m_allocations.load();
+        stats.frame_allocations = m_frame_allocations.load();
+        stats.frame_deallocations = m_frame_deallocations.load();
+        stats.frame_failed_allocations = m_frame_failed_allocations.load();
+        stats.failed_allocations = m_failed_allocations.load();
+
+        return stats;
+    }
+
+    void BaseMemoryPool::resetFrameStats()
+    {
+        m_frame_allocations = 0;
+        m_frame_deallocations = 0;
+        m_frame_failed_allocations = 0;
+    }
+
+    void BaseMemoryPool::recordAllocation(std::size_t size)
+    {
+        m_allocations++;
+        m_frame_allocations++;
+
+        std::size_t allocated = m_used_size.fetch_add(size) + size;
+        std::size_t peak = m_peak_size.load();
+        while (allocated > peak && !m_peak_size.compare_exchange_weak(peak, allocated));
+    }
+
+    void BaseMemoryPool::recordDeallocation(std::size_t size, glm::u32 count)
+    {
+        m_allocations -= count;
+        m_frame_deallocations += count;
+        m_used_size -= size;
+
+        ERIS_TRACK_DEALLOCATION(size, count);
+    }
+
+    void BaseMemoryPool::recordFailure()
+    {
+        m_frame_failed_allocations++;
+        m_failed_allocations++;
+    }
+
+    void BaseMemoryPool::recordChunks(glm::i32 count)
+    {
+        m_chunks += count;
+    }
+
+    BaseMemoryPool* MemoryPoolRegistry::s_pools[MEMORY_POOL_MAX];
+    glm::u16 MemoryPoolRegistry::s_generations[MEMORY_POOL_MAX];
+
+    glm::u32 MemoryPoolRegistry::add(BaseMemoryPool* pool)
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        if (!registry.exit_callback)
+        {
+            addThreadExitCallback(&MemoryPoolRegistry::releaseThread);
+            registry.exit_callback = true;
+        }
+
+        for (glm::u16 i = 0; i < MEMORY_POOL_MAX; i++)
+        {
+            if (!s_pools[i])
+            {
+                s_pools[i] = pool;
+                return (glm::u32(s_generations[i]) << 16) | i;
+            }
+        }
+
+        Log::error("Memory pool registry is full, allocators cannot use the new pool");
+        return MEMORY_POOL_INVALID;
+    }
+
+    void MemoryPoolRegistry::remove(BaseMemoryPool* pool)
+    {
+        glm::u32 handle = pool->getHandle();
+        if (handle == MEMORY_POOL_INVALID)
+            return;
+
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        glm::u32 slot = handle & 0xFFFF;
+        ERIS_ASSERT(s_pools[slot] == pool);
+        s_pools[slot] = nullptr;
+        s_generations[slot]++;
+    }
+
+    void MemoryPoolRegistry::invalidHandle(glm::u32 handle)
+    {
+        Log::errorf("Memory pool handle %08x is invalid or its pool was destroyed", handle);
+        std::abort();
+    }
+
+    std::vector<BaseMemoryPool::Stats> MemoryPoolRegistry::getStats()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        std::vector<BaseMemoryPool::Stats> stats;
+        for (BaseMemoryPool* pool : s_pools)
+        {
+            if (pool)
+                stats.push_back(pool->getStats());
+        }
+
+        return stats;
+    }
+
+    std::vector<BaseMemoryPool::Stats> MemoryPoolRegistry::getFrameReport()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        return registry.report;
+    }
+
+    std::size_t MemoryPoolRegistry::getUsedSize()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        std::size_t used = 0;
+        for (BaseMemoryPool* pool : s_pools)
+        {
+            if (pool)
+                used += pool->getUsedSize();
+        }
+
+        return used;
+    }
+
+    void MemoryPoolRegistry::releaseThread(glm::u32 thread)
+    {
+        // Holding the registry lock keeps the pools from being destroyed underneath.
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        for (BaseMemoryPool* pool : s_pools)
+        {
+            if (pool && pool->getType() == BaseMemoryPool::Type::SLAB)
+                static_cast<SlabMemoryPool*>(pool)->releaseThread(thread);
+            else if (pool && pool->getType() == BaseMemoryPool::Type::CHAIN)
+                static_cast<ChainMemoryPool*>(pool)->releaseThread(thread);
+        }
+    }
+
+    void MemoryPoolRegistry::endFrame()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<SpinLock> lock(registry.lock);
+
+        registry.report.clear();
+        for (BaseMemoryPool* pool : s_pools)
+        {
+            if (!pool)
+                continue;
+
+            registry.report.push_back(pool->getStats());
+            pool->resetFrameStats();
+
+            const BaseMemoryPool::Stats& stats = registry.report.back();
+            if (stats.frame_failed_allocations)
+                Log::warnf("Memory pool %s failed %u allocations", stats.name.c_str(), stats.frame_failed_allocations);
+        }
+    }
 
     HeapMemoryPool::HeapMemoryPool() :
         BaseMemoryPool(Type::HEAP)
@@ -92,41 +318,76 @@ namespace Eris
 
     void* HeapMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
     {
-        void* out = _aligned_malloc(size, alignment_bits);
+        ERIS_TRACK_ALLOCATION(Type::HEAP, size);
+
+        std::size_t header_size = getAlignedRoundUp(alignment_bits, sizeof(MemoryBlockHeader));
+
+        glm::u8* out = reinterpret_cast<glm::u8*>(_aligned_malloc(header_size + size, alignment_bits));
         if (out)
         {
+            out += header_size;
             ERIS_ASSERT(aligned(alignment_bits, out));
-            m_allocations++;
+
+            MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(out) - 1;
+            header->size = size;
+            header->offset = header_size;
+
+            recordAllocation(size);
         }
         else
+        {
             Log::error("Not enough memory for allocation");
+            recordFailure();
+        }
 
         return out;
     }
 
     void HeapMemoryPool::deallocate(void* ptr)
     {
-        m_allocations--;
-        _aligned_free(ptr);
+        if (!ptr)
+            return;
+
+        MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(ptr) - 1;
+        recordDeallocation(header->size);
+
+        _aligned_free(reinterpret_cast<glm::u8*>(ptr) - header->offset);
     }
 
-    StackMemoryPool::StackMemoryPool(std::size_t size, bool deallocation_flag, std::size_t alignment_bits) :
+    StackMemoryPool::StackMemoryPool(std::size_t size, bool deallocation_flag, std::size_t alignment_bits, bool virtual_flag) :
         BaseMemoryPool(Type::STACK),
         m_deallocation_flag(deallocation_flag),
+        m_virtual_flag(virtual_flag),
+        m_decommit_flag(false),
         m_alignment_bits(alignment_bits),
         m_head(nullptr),
+        m_committed(nullptr),
+        m_commit_lock(),
         m_memory(nullptr),
         m_mem_size(size)
     {
         ERIS_ASSERT(size > 0);
         ERIS_ASSERT(alignment_bits > 0);
 
-        m_mem_size = getAlignedRoundUp(alignment_bits, size);
-        m_memory = reinterpret_cast<glm::u8*>(_aligned_malloc(m_mem_size, alignment_bits));
+        if (m_virtual_flag)
+        {
+            ERIS_ASSERT(alignment_bits <= STACK_COMMIT_SIZE);
+
+            m_mem_size = getAlignedRoundUp(STACK_COMMIT_SIZE, size);
+            m_memory = reinterpret_cast<glm::u8*>(VirtualAlloc(nullptr, m_mem_size, MEM_RESERVE, PAGE_NOACCESS));
+        }
+        else
+        {
+            m_mem_size = getAlignedRoundUp(alignment_bits, size);
+            m_memory = reinterpret_cast<glm::u8*>(_aligned_malloc(m_mem_size, alignment_bits));
+        }
+
         if (m_memory)
         {
             m_head = m_memory;
+            m_committed = m_virtual_flag ? m_memory : m_memory + m_mem_size;
             m_header_size = getAlignedRoundUp(alignment_bits, sizeof(MemoryBlockHeader));
+            recordChunks(1);
         }
         else
         {
@@ -137,18 +398,25 @@ namespace Eris
     StackMemoryPool::~StackMemoryPool()
     {
         if (m_memory)
-            _aligned_free(m_memory);
+        {
+            if (m_virtual_flag)
+                VirtualFree(m_memory, 0, MEM_RELEASE);
+            else
+                _aligned_free(m_memory);
+        }
     }
 
     void* StackMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
     {
+        ERIS_TRACK_ALLOCATION(Type::STACK, size);
+
         ERIS_ASSERT(alignment_bits <= m_alignment_bits);
         (void) alignment_bits;
 
         size = getAlignedRoundUp(m_alignment_bits, size + m_header_size);
 
         glm::u8* out = m_head.fetch_add(size);
-        if (out + size <= m_memory + m_mem_size)
+        if (out + size <= m_memory + m_mem_size && (out + size <= m_committed.load() || commit(out + size)))
         {
             MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(out);
             std::size_t size32 = size;
@@ -158,11 +426,12 @@ namespace Eris
             
             ERIS_ASSERT(aligned(m_alignment_bits, out));
 
-            m_allocations++;
+            recordAllocation(size);
         }
         else
         {
             Log::error("Not enough memory for allocation");
+            recordFailure();
             m_head = out;
             out = nullptr;
         }
@@ -190,7 +459,7 @@ namespace Eris
 
         bool exchange = m_head.compare_exchange_strong(expected, desired);
 
-        m_allocations--;
+        recordDeallocation(size);
 
         if (!m_deallocation_flag && !exchange)
         {
@@ -200,22 +469,62 @@ namespace Eris
 
     StackMemoryPool::Snapshot StackMemoryPool::takeSnapshot() const
     {
-        return m_head.load();
+        Snapshot s;
+        s.head = m_head.load();
+        s.used_size = getUsedSize();
+        s.allocations = m_allocations.load();
+
+        return s;
     }
 
     void StackMemoryPool::resetUsingSnapshot(StackMemoryPool::Snapshot s)
     {
-        ERIS_ASSERT(static_cast<glm::u8*>(s) >= m_memory);
-        ERIS_ASSERT(static_cast<glm::u8*>(s) <= m_memory + m_mem_size);
+        ERIS_ASSERT(s.head >= m_memory);
+        ERIS_ASSERT(s.head <= m_memory + m_mem_size);
 
-        m_head.store(static_cast<glm::u8*>(s));
+        m_head.store(s.head);
+
+        // Anything allocated since the snapshot and not yet freed is released in bulk.
+        glm::u32 allocations = m_allocations.load();
+        if (allocations > s.allocations)
+            recordDeallocation(getUsedSize() - s.used_size, allocations - s.allocations);
     }
 
     void StackMemoryPool::reset()
     {
         ERIS_ASSERT(m_memory);
         m_head = m_memory;
-        m_allocations = 0;
+        recordDeallocation(getUsedSize(), m_allocations);
+
+        if (m_virtual_flag && m_decommit_flag)
+        {
+            std::lock_guard<SpinLock> lock(m_commit_lock);
+
+            glm::u8* committed = m_committed.load();
+            if (committed > m_memory)
+                VirtualFree(m_memory, committed - m_memory, MEM_DECOMMIT);
+
+            m_committed = m_memory;
+        }
+    }
+
+    bool StackMemoryPool::commit(glm::u8* end)
+    {
+        ERIS_ASSERT(m_virtual_flag);
+
+        std::lock_guard<SpinLock> lock(m_commit_lock);
+
+        glm::u8* committed = m_committed.load();
+        if (end <= committed)
+            return true;
+
+        std::size_t size = glm::min(getAlignedRoundUp(STACK_COMMIT_SIZE, static_cast<std::size_t>(end - committed)), static_cast<std::size_t>(m_memory + m_mem_size - committed));
+        if (!VirtualAlloc(committed, size, MEM_COMMIT, PAGE_READWRITE))
+            return false;
+
+        m_committed = committed + size;
+
+        return true;
     }
 
     ChainMemoryPool::ChainMemoryPool(std::size_t initial_chunk_size, std::size_t max_chunk_size, ChunkGrowMethod chunk_grow_method, std::size_t chunk_alloc_step, std::size_t alignment_bits) :
@@ -224,12 +533,17 @@ namespace Eris
         m_head_chunk(nullptr),
         m_init_size(initial_chunk_size),
         m_max_size(max_chunk_size),
-        m_tail_chunk(nullptr),
         m_step(chunk_alloc_step),
         m_method(chunk_grow_method),
-        m_lock()
+        m_lock(),
+        m_tail_lock(),
+        m_allocated_size(0)
     {
+        m_lock.setName("ChainMemoryPool");
+        m_tail_lock.setName("ChainMemoryPool");
+
         ERIS_ASSERT(m_init_size > 0);
+        ERIS_ASSERT(alignment_bits > 0);
 
         if (m_method == ChunkGrowMethod::FIXED)
         {
@@ -239,6 +553,11 @@ namespace Eris
 
         if (m_method == ChunkGrowMethod::ADD || m_method == ChunkGrowMethod::MULTIPLY)
             ERIS_ASSERT(m_init_size < m_max_size);
+
+        m_header_size = getAlignedRoundUp(alignment_bits, sizeof(MemoryBlockHeader));
+
+        for (glm::u32 i = 0; i <= CHAIN_MAX_THREADS; i++)
+            m_tails[i] = nullptr;
     }
 
     ChainMemoryPool::~ChainMemoryPool()
@@ -259,31 +578,29 @@ namespace Eris
 
     void* ChainMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
     {
+        ERIS_TRACK_ALLOCATION(Type::CHAIN, size);
+
         ERIS_ASSERT(size < m_max_size);
+        ERIS_ASSERT(alignment_bits <= m_alignment_bits);
+        (void) alignment_bits;
 
-        Chunk* ch;
         void* out = nullptr;
 
-        std::lock_guard<SpinLock> lock(m_lock);
-
-        ch = m_tail_chunk;
-
-        if (!ch || !(out = allocateFromChunk(ch, size, alignment_bits)))
-        {
-            std::size_t chunk_size = computeChunkSize(size);
-            ch = createChunk(chunk_size);
-
-            if (!ch)
-                return out;
-        }
-
-        if (!out)
+        // Each thread bumps its own tail chunk, only threads without a slot
+        // share the locked tail.
+        glm::u32 thread = getThreadIndex();
+        if (thread < CHAIN_MAX_THREADS)
+            out = allocateFromTail(m_tails[thread], size);
+        else
         {
-            out = allocateFromChunk(ch, size, alignment_bits);
-            ERIS_ASSERT(out);
+            std::lock_guard<AdaptiveLock> lock(m_tail_lock);
+            out = allocateFromTail(m_tails[SHARED_TAIL], size);
         }
 
-        m_allocations++;
+        if (out)
+            recordAllocation(size);
+        else
+            recordFailure();
 
         return out;
     }
@@ -293,78 +610,73 @@ namespace Eris
         if (!ptr)
             return;
 
-        std::lock_guard<SpinLock> lock(m_lock);
-
-        Chunk* current = m_head_chunk;
-        Chunk* prev = nullptr;
-        const glm::u8* cptr = reinterpret_cast<const glm::u8*>(ptr);
+        ERIS_ASSERT(aligned(m_alignment_bits, ptr));
 
-        while (current)
-        {
-            const glm::u8* from = current->memory;
-            const glm::u8* to = from + current->mem_size;
-            if (cptr >= from && cptr <= to)
-                break;
+        MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(reinterpret_cast<glm::u8*>(ptr) - m_header_size);
+        Chunk* ch = header->chunk;
 
-            prev = current;
-            current = current->next;
-        }
+        ERIS_ASSERT(ch);
+        ERIS_ASSERT(reinterpret_cast<glm::u8*>(header) >= ch->memory && reinterpret_cast<glm::u8*>(header) < ch->memory + ch->mem_size);
 
-        ERIS_ASSERT(current);
-        ERIS_ASSERT(current->allocation_count > 0);
+        recordDeallocation(header->size);
 
-        if (--current->allocation_count == 0)
-        {
-            if (prev)
-            {
-                ERIS_ASSERT(m_head_chunk != current);
-                prev->next = current->next;
-            }
+        releaseChunk(ch);
+    }
+   
+    std::size_t ChainMemoryPool::getChunksCount() const
+    {
+        return getChunks();
+    }
 
-            if (current == m_head_chunk)
-            {
-                ERIS_ASSERT(!prev);
-                m_head_chunk = current->next;
-            }
+    std::size_t ChainMemoryPool::getAllocatedSize() const
+    {
+        return m_allocated_size.load();
+    }
 
-            if (current == m_tail_chunk)
-                m_tail_chunk = prev;
+    void ChainMemoryPool::releaseThread(glm::u32 thread)
+    {
+        if (thread >= CHAIN_MAX_THREADS)
+            return;
 
-            destroyChunk(current);
-        }
+        // Only the exiting thread used this tail, it is the one calling.
+        Chunk* tail = m_tails[thread];
+        m_tails[thread] = nullptr;
 
-        m_allocations--;
+        if (tail)
+            releaseChunk(tail);
     }
-   
-    std::size_t ChainMemoryPool::getChunksCount() const
+
+    void* ChainMemoryPool::allocateFromTail(Chunk*& tail, std::size_t size)
     {
-        std::size_t count = 0;
+        void* out = nullptr;
 
-        Chunk* ch = m_head_chunk;
-        while (ch)
+        // A tail holds one extra reference for as long as it is a tail, so a
+        // count of one means every block in it has been freed.
+        if (tail && tail->allocation_count.load() == 1 && tail->head != tail->memory)
         {
-            count++;
-            ch = ch->next;
+            m_allocated_size -= tail->head - tail->memory;
+            tail->head = tail->memory;
         }
 
-        return count;
-    }
+        if (!tail || !(out = allocateFromChunk(tail, size)))
+        {
+            Chunk* ch = createChunk(computeChunkSize(tail, size));
+            if (!ch)
+                return out;
 
-    std::size_t ChainMemoryPool::getAllocatedSize() const
-    {
-        std::size_t size = 0;
+            if (tail)
+                releaseChunk(tail);
 
-        Chunk* ch = m_head_chunk;
-        while (ch)
-        {
-            size += ch->head - ch->memory;
-            ch = ch->next;
+            tail = ch;
+
+            out = allocateFromChunk(tail, size);
+            ERIS_ASSERT(out);
         }
 
-        return size;
+        return out;
     }
 
-    std::size_t ChainMemoryPool::computeChunkSize(std::size_t size)
+    std::size_t ChainMemoryPool::computeChunkSize(Chunk* tail, std::size_t size)
     {
         std::size_t current_max = 0;
         if (m_method == ChunkGrowMethod::FIXED)
@@ -373,9 +685,9 @@ namespace Eris
         }
         else
         {
-            if (m_tail_chunk)
+            if (tail)
             {
-                current_max = m_tail_chunk->mem_size;
+                current_max = tail->mem_size;
                 ERIS_ASSERT(current_max > 0);
 
                 if (m_method == ChunkGrowMethod::MULTIPLY)
@@ -391,7 +703,7 @@ namespace Eris
             current_max = glm::min(current_max, m_max_size);
         }
 
-        size = glm::max(current_max, size) + m_alignment_bits;
+        size = glm::max(current_max, size + m_header_size) + m_alignment_bits;
 
         return size;
     }
@@ -410,17 +722,16 @@ namespace Eris
             {
                 ch->mem_size = size;
                 ch->head = ch->memory;
+                ch->allocation_count = 1;
+                recordChunks(1);
 
-                if (m_tail_chunk)
-                {
-                    m_tail_chunk->next = ch;
-                    m_tail_chunk = ch;
-                }
-                else
-                {
-                    ERIS_ASSERT(!m_head_chunk);
-                    m_head_chunk = m_tail_chunk = ch;
-                }
+                std::lock_guard<AdaptiveLock> lock(m_lock);
+
+                ch->next = m_head_chunk;
+                if (m_head_chunk)
+                    m_head_chunk->prev = ch;
+
+                m_head_chunk = ch;
             }
             else
             {
@@ -438,7 +749,7 @@ namespace Eris
         return ch;
     }
 
-    void* ChainMemoryPool::allocateFromChunk(Chunk* ch, std::size_t size, std::size_t alignment_bits)
+    void* ChainMemoryPool::allocateFromChunk(Chunk* ch, std::size_t size)
     {
         ERIS_ASSERT(ch);
         ERIS_ASSERT(size <= m_max_size);
@@ -446,12 +757,19 @@ namespace Eris
 
         glm::u8* mem = ch->head;
         alignRoundUp(m_alignment_bits, mem);
-        glm::u8* head = mem + size;
+        glm::u8* head = mem + m_header_size + size;
 
         if (head <= ch->memory + ch->mem_size)
         {
+            MemoryBlockHeader* header = reinterpret_cast<MemoryBlockHeader*>(mem);
+            header->chunk = ch;
+            header->size = size;
+
+            m_allocated_size += head - ch->head;
             ch->head = head;
             ch->allocation_count++;
+
+            mem += m_header_size;
         }
         else
             mem = nullptr;
@@ -459,13 +777,847 @@ namespace Eris
         return mem;
     }
 
+    void ChainMemoryPool::releaseChunk(Chunk* ch)
+    {
+        ERIS_ASSERT(ch->allocation_count > 0);
+
+        if (--ch->allocation_count == 0)
+        {
+            {
+                std::lock_guard<AdaptiveLock> lock(m_lock);
+
+                if (ch->prev)
+                    ch->prev->next = ch->next;
+                else
+                {
+                    ERIS_ASSERT(m_head_chunk == ch);
+                    m_head_chunk = ch->next;
+                }
+
+                if (ch->next)
+                    ch->next->prev = ch->prev;
+            }
+
+            destroyChunk(ch);
+        }
+    }
+
     void ChainMemoryPool::destroyChunk(ChainMemoryPool::Chunk* ch)
     {
         ERIS_ASSERT(ch);
 
+        recordChunks(-1);
+        m_allocated_size -= ch->head - ch->memory;
+
         if (ch->memory)
             _aligned_free(ch->memory);
 
         _aligned_free(ch);
     }
+
+    FrameMemoryPool::FrameMemoryPool(std::size_t frame_size, glm::u32 frames, std::size_t alignment_bits) :
+        BaseMemoryPool(Type::FRAME),
+        m_alignment_bits(alignment_bits),
+        m_frame_size(frame_size),
+        m_last_frame_size(0),
+        m_high_water_mark(0),
+        m_frames_count(frames),
+        m_current(0),
+        m_lock(),
+        m_frames(nullptr)
+    {
+        ERIS_ASSERT(frame_size > 0);
+        ERIS_ASSERT(frames > 0);
+        ERIS_ASSERT(alignment_bits > 0);
+
+        m_frame_size = getAlignedRoundUp(alignment_bits, frame_size);
+        m_header_size = getAlignedRoundUp(alignment_bits, sizeof(Block));
+
+        m_frames = new Frame[m_frames_count];
+        for (glm::u32 i = 0; i < m_frames_count; i++)
+        {
+            Frame& frame = m_frames[i];
+            frame.first = createBlock(m_frame_size);
+            frame.current = frame.first;
+            frame.destructors = nullptr;
+            frame.size = 0;
+            frame.allocations = 0;
+        }
+    }
+
+    FrameMemoryPool::~FrameMemoryPool()
+    {
+        for (glm::u32 i = 0; i < m_frames_count; i++)
+        {
+            recycleFrame(m_frames[i]);
+            destroyBlocks(m_frames[i].first);
+        }
+
+        delete[] m_frames;
+    }
+
+    void* FrameMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
+    {
+        ERIS_TRACK_ALLOCATION(Type::FRAME, size);
+
+        return allocateFromFrame(getFrame(), size, alignment_bits);
+    }
+
+    void FrameMemoryPool::deallocate(void* ptr)
+    {
+        // Memory is released in bulk when the frame is recycled.
+        (void) ptr;
+    }
+
+    void FrameMemoryPool::nextFrame()
+    {
+        glm::u32 current = m_current.load();
+        std::size_t size = m_frames[current].size.load();
+
+        m_last_frame_size = size;
+        if (size > m_high_water_mark)
+            m_high_water_mark = size;
+
+        glm::u32 next = (current + 1) % m_frames_count;
+        recycleFrame(m_frames[next]);
+        m_current = next;
+    }
+
+    void* FrameMemoryPool::allocateFromFrame(Frame& frame, std::size_t size, std::size_t alignment_bits)
+    {
+        ERIS_ASSERT(alignment_bits <= m_alignment_bits);
+        (void) alignment_bits;
+
+        size = getAlignedRoundUp(m_alignment_bits, size);
+
+        while (true)
+        {
+            Block* block = frame.current.load();
+            if (block)
+            {
+                glm::u8* out = block->head.fetch_add(size);
+                if (out + size <= block->end)
+                {
+                    ERIS_ASSERT(aligned(m_alignment_bits, out));
+
+                    frame.size += size;
+                    frame.allocations++;
+                    recordAllocation(size);
+
+                    return out;
+                }
+            }
+
+            std::lock_guard<SpinLock> lock(m_lock);
+            if (frame.current.load() != block)
+                continue;
+
+            Block* overflow = createBlock(glm::max(size, m_frame_size));
+            if (!overflow)
+            {
+                recordFailure();
+                return nullptr;
+            }
+
+            if (block)
+                block->next = overflow;
+            else
+                frame.first = overflow;
+
+            frame.current = overflow;
+        }
+    }
+
+    void FrameMemoryPool::addDestructor(Frame& frame, void* object, DestructorFunction function)
+    {
+        Destructor* record = reinterpret_cast<Destructor*>(allocateFromFrame(frame, sizeof(Destructor), __alignof(Destructor)));
+        if (!record)
+            return;
+
+        record->function = function;
+        record->object = object;
+        record->next = frame.destructors.load();
+        while (!frame.destructors.compare_exchange_weak(record->next, record));
+    }
+
+    void FrameMemoryPool::recycleFrame(Frame& frame)
+    {
+        Destructor* record = frame.destructors.exchange(nullptr);
+        while (record)
+        {
+            Destructor* next = record->next;
+            record->function(record->object);
+            record = next;
+        }
+
+        std::lock_guard<SpinLock> lock(m_lock);
+
+        // Fold any overflow into a single block sized for the frame that needed it.
+        if (frame.first && frame.first->next)
+        {
+            std::size_t size = getAlignedRoundUp(m_alignment_bits, frame.size.load());
+            destroyBlocks(frame.first);
+            frame.first = createBlock(glm::max(size, m_frame_size));
+        }
+
+        if (frame.first)
+            frame.first->head = frame.first->memory;
+
+        frame.current = frame.first;
+        recordDeallocation(frame.size.exchange(0), frame.allocations.exchange(0));
+    }
+
+    FrameMemoryPool::Block* FrameMemoryPool::createBlock(std::size_t size)
+    {
+        ERIS_ASSERT(size > 0);
+
+        glm::u8* memory = reinterpret_cast<glm::u8*>(_aligned_malloc(m_header_size + size, m_alignment_bits));
+        if (!memory)
+        {
+            Log::error("Not enough memory for allocation");
+            return nullptr;
+        }
+
+        Block* block = reinterpret_cast<Block*>(memory);
+        construct(block);
+        block->memory = memory + m_header_size;
+        block->end = block->memory + size;
+        block->head = block->memory;
+
+        recordChunks(1);
+
+        return block;
+    }
+
+    void FrameMemoryPool::destroyBlocks(Block* block)
+    {
+        while (block)
+        {
+            Block* next = block->next;
+            destruct(block);
+            _aligned_free(block);
+            recordChunks(-1);
+            block = next;
+        }
+    }
+
+    SlabMemoryPool::SlabMemoryPool(std::size_t slab_size, std::size_t alignment_bits) :
+        BaseMemoryPool(Type::SLAB),
+        m_slab_size(slab_size),
+        m_alignment_bits(alignment_bits),
+        m_arena_count(0),
+        m_arena_used(0)
+    {
+        ERIS_ASSERT(powerOfTwo(slab_size) && slab_size <= SLAB_ARENA_SIZE);
+        ERIS_ASSERT(alignment_bits > 0 && alignment_bits <= SLAB_GRANULARITY);
+        ERIS_ASSERT(slab_size >= SLAB_MAX_BLOCK_SIZE * 4);
+
+        m_header_size = getAlignedRoundUp(SLAB_GRANULARITY, sizeof(Slab));
+
+        for (glm::u32 i = 0; i < SLAB_SIZE_CLASSES; i++)
+        {
+            m_classes[i].block_size = (i + 1) * SLAB_GRANULARITY;
+            m_classes[i].magazine_size = static_cast<glm::u32>(glm::clamp<std::size_t>(SLAB_MAGAZINE_BYTES / m_classes[i].block_size, 2, SLAB_MAGAZINE_SIZE));
+        }
+
+        for (glm::u32 i = 0; i < SLAB_MAX_THREADS; i++)
+            m_magazines[i] = nullptr;
+
+        for (glm::u32 i = 0; i < SLAB_MAX_ARENAS; i++)
+        {
+            m_arenas[i] = nullptr;
+            m_arena_reservations[i] = nullptr;
+        }
+    }
+
+    SlabMemoryPool::~SlabMemoryPool()
+    {
+        if (m_allocations != 0)
+        {
+            Log::warn("Destruct called with allocations undeleted");
+        }
+
+        for (glm::u32 i = 0; i < SLAB_MAX_THREADS; i++)
+        {
+            Magazine* magazines = m_magazines[i].load();
+            if (magazines)
+            {
+                for (glm::u32 j = 0; j < SLAB_SIZE_CLASSES; j++)
+                    destruct(&magazines[j]);
+
+                _aligned_free(magazines);
+            }
+        }
+
+        for (glm::u32 i = 0; i < m_arena_count; i++)
+            VirtualFree(m_arena_reservations[i], 0, MEM_RELEASE);
+    }
+
+    void* SlabMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
+    {
+        ERIS_TRACK_ALLOCATION(Type::SLAB, size);
+
+        ERIS_ASSERT(alignment_bits <= m_alignment_bits);
+        (void) alignment_bits;
+
+        if (size > SLAB_MAX_BLOCK_SIZE)
+            return allocateLarge(size);
+
+        glm::u32 index = static_cast<glm::u32>((glm::max<std::size_t>(size, 1) + SLAB_GRANULARITY - 1) / SLAB_GRANULARITY) - 1;
+        Block* block = nullptr;
+
+        Magazine* magazines = getMagazines();
+        if (magazines)
+        {
+            Magazine& magazine = magazines[index];
+            if (!magazine.count)
+                magazine.count = popBlocks(index, magazine.blocks, m_classes[index].magazine_size / 2);
+
+            if (magazine.count)
+                block = magazine.blocks[--magazine.count];
+        }
+        else
+            popBlocks(index, &block, 1);
+
+        if (block)
+            recordAllocation(m_classes[index].block_size);
+        else
+            recordFailure();
+
+        return block;
+    }
+
+    void SlabMemoryPool::deallocate(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        if (!ownsSlab(ptr))
+        {
+            Slab* header = reinterpret_cast<Slab*>(reinterpret_cast<glm::u8*>(ptr) - m_header_size);
+            ERIS_ASSERT(header->size_class == LARGE_CLASS);
+
+            recordDeallocation(header->size);
+            recordChunks(-1);
+            _aligned_free(header);
+            return;
+        }
+
+        Slab* slab = getAlignedRoundDown(m_slab_size, reinterpret_cast<Slab*>(ptr));
+        ERIS_ASSERT(slab->size_class < LARGE_CLASS);
+
+        glm::u32 index = slab->size_class;
+        recordDeallocation(m_classes[index].block_size);
+        Block* block = reinterpret_cast<Block*>(ptr);
+
+        Magazine* magazines = getMagazines();
+        if (magazines)
+        {
+            Magazine& magazine = magazines[index];
+            glm::u32 magazine_size = m_classes[index].magazine_size;
+            if (magazine.count == magazine_size)
+            {
+                magazine.count -= magazine_size / 2;
+                pushBlocks(index, &magazine.blocks[magazine.count], magazine_size / 2);
+            }
+
+            magazine.blocks[magazine.count++] = block;
+        }
+        else
+            pushBlocks(index, &block, 1);
+    }
+
+    void SlabMemoryPool::releaseThread(glm::u32 thread)
+    {
+        if (thread >= SLAB_MAX_THREADS)
+            return;
+
+        // Only the exiting thread used these, it is the one calling.
+        Magazine* magazines = m_magazines[thread].exchange(nullptr);
+        if (!magazines)
+            return;
+
+        for (glm::u32 i = 0; i < SLAB_SIZE_CLASSES; i++)
+        {
+            if (magazines[i].count)
+                pushBlocks(i, magazines[i].blocks, magazines[i].count);
+
+            destruct(&magazines[i]);
+        }
+
+        _aligned_free(magazines);
+    }
+
+    SlabMemoryPool* SlabMemoryPool::getDefault()
+    {
+        static std::atomic<SlabMemoryPool*> s_default(nullptr);
+        static std::atomic_flag s_creating = ATOMIC_FLAG_INIT;
+        static ERIS_THREAD_LOCAL bool t_creating = false;
+
+        SlabMemoryPool* pool = s_default.load(std::memory_order_acquire);
+        if (pool || t_creating)
+            return pool;
+
+        if (!s_creating.test_and_set())
+        {
+            // The default pool is ref counted itself, so allocating it asks for
+            // the default pool again and has to fall back to the heap.
+            t_creating = true;
+            pool = new SlabMemoryPool();
+            pool->setName("Slab");
+            pool->increment();
+            t_creating = false;
+
+            s_default.store(pool, std::memory_order_release);
+        }
+        else
+        {
+            while (!(pool = s_default.load(std::memory_order_acquire)))
+                std::this_thread::yield();
+        }
+
+        return pool;
+    }
+
+    SlabMemoryPool::Magazine* SlabMemoryPool::getMagazines()
+    {
+        glm::u32 thread = getThreadIndex();
+        if (thread >= SLAB_MAX_THREADS)
+            return nullptr;
+
+        Magazine* magazines = m_magazines[thread].load(std::memory_order_acquire);
+        if (!magazines)
+        {
+            magazines = reinterpret_cast<Magazine*>(_aligned_malloc(sizeof(Magazine) * SLAB_SIZE_CLASSES, __alignof(Magazine)));
+            if (!magazines)
+                return nullptr;
+
+            for (glm::u32 i = 0; i < SLAB_SIZE_CLASSES; i++)
+                construct(&magazines[i]);
+
+            m_magazines[thread].store(magazines, std::memory_order_release);
+        }
+
+        return magazines;
+    }
+
+    glm::u32 SlabMemoryPool::popBlocks(glm::u32 index, Block** out, glm::u32 count)
+    {
+        SizeClass& size_class = m_classes[index];
+        std::lock_guard<SpinLock> lock(size_class.lock);
+
+        glm::u32 popped = 0;
+        while (popped < count)
+        {
+            if (!size_class.free && !createSlab(size_class, index))
+                break;
+
+            out[popped++] = size_class.free;
+            size_class.free = size_class.free->next;
+        }
+
+        return popped;
+    }
+
+    void SlabMemoryPool::pushBlocks(glm::u32 index, Block** in, glm::u32 count)
+    {
+        SizeClass& size_class = m_classes[index];
+        std::lock_guard<SpinLock> lock(size_class.lock);
+
+        for (glm::u32 i = 0; i < count; i++)
+        {
+            in[i]->next = size_class.free;
+            size_class.free = in[i];
+        }
+    }
+
+    bool SlabMemoryPool::createSlab(SizeClass& size_class, glm::u32 index)
+    {
+        glm::u8* memory = commitSlab();
+        if (!memory)
+        {
+            Log::error("Not enough memory for allocation");
+            return false;
+        }
+
+        Slab* slab = reinterpret_cast<Slab*>(memory);
+        slab->size_class = index;
+        slab->size = m_slab_size;
+
+        glm::u8* end = memory + m_slab_size;
+        for (glm::u8* block = memory + m_header_size; block + size_class.block_size <= end; block += size_class.block_size)
+        {
+            Block* free = reinterpret_cast<Block*>(block);
+            free->next = size_class.free;
+            size_class.free = free;
+        }
+
+        recordChunks(1);
+
+        return true;
+    }
+
+    glm::u8* SlabMemoryPool::commitSlab()
+    {
+        std::lock_guard<SpinLock> lock(m_arena_lock);
+
+        glm::u32 count = m_arena_count.load(std::memory_order_relaxed);
+        if (!count || m_arena_used + m_slab_size > SLAB_ARENA_SIZE)
+        {
+            if (count == SLAB_MAX_ARENAS)
+                return nullptr;
+
+            // One slab of slack so the arena can start on a slab boundary.
+            glm::u8* reservation = reinterpret_cast<glm::u8*>(VirtualAlloc(nullptr, SLAB_ARENA_SIZE + m_slab_size, MEM_RESERVE, PAGE_NOACCESS));
+            if (!reservation)
+                return nullptr;
+
+            m_arena_reservations[count] = reservation;
+            m_arenas[count].store(getAlignedRoundUp(m_slab_size, reservation), std::memory_order_relaxed);
+            m_arena_count.store(++count, std::memory_order_release);
+            m_arena_used = 0;
+        }
+
+        glm::u8* memory = m_arenas[count - 1].load(std::memory_order_relaxed) + m_arena_used;
+        if (!VirtualAlloc(memory, m_slab_size, MEM_COMMIT, PAGE_READWRITE))
+            return nullptr;
+
+        m_arena_used += m_slab_size;
+        return memory;
+    }
+
+    bool SlabMemoryPool::ownsSlab(const void* ptr) const
+    {
+        const glm::u8* address = reinterpret_cast<const glm::u8*>(ptr);
+
+        glm::u32 count = m_arena_count.load(std::memory_order_acquire);
+        for (glm::u32 i = 0; i < count; i++)
+        {
+            const glm::u8* arena = m_arenas[i].load(std::memory_order_relaxed);
+            if (address >= arena && address < arena + SLAB_ARENA_SIZE)
+                return true;
+        }
+
+        return false;
+    }
+
+    void* SlabMemoryPool::allocateLarge(std::size_t size)
+    {
+        // Oversized requests get a header in front, deallocate finds it because the block lies outside the arenas.
+        glm::u8* memory = reinterpret_cast<glm::u8*>(_aligned_malloc(m_header_size + size, SLAB_GRANULARITY));
+        if (!memory)
+        {
+            Log::error("Not enough memory for allocation");
+            recordFailure();
+            return nullptr;
+        }
+
+        Slab* slab = reinterpret_cast<Slab*>(memory);
+        slab->size_class = LARGE_CLASS;
+        slab->size = size;
+
+        recordAllocation(size);
+        recordChunks(1);
+
+        return memory + m_header_size;
+    }
+
+    TlsfMemoryPool::TlsfMemoryPool(std::size_t area_size, std::size_t alignment_bits) :
+        BaseMemoryPool(Type::TLSF),
+        m_area_size(area_size),
+        m_alignment_bits(alignment_bits),
+        m_lock(),
+        m_areas(nullptr),
+        m_fl_bitmap(0)
+    {
+        ERIS_ASSERT(alignment_bits > 0 && alignment_bits <= 16);
+        ERIS_ASSERT(area_size > SMALL_BLOCK_SIZE);
+
+        // Block sizes are multiples of 16, which keeps the flag bits free and every payload aligned.
+        m_block_header_size = offsetof(Block, next_free);
+        m_min_block_size = sizeof(Block) - m_block_header_size;
+
+        for (glm::u32 i = 0; i < FL_INDEX_COUNT; i++)
+        {
+            m_sl_bitmap[i] = 0;
+            for (glm::u32 j = 0; j < SL_INDEX_COUNT; j++)
+                m_blocks[i][j] = nullptr;
+        }
+    }
+
+    TlsfMemoryPool::~TlsfMemoryPool()
+    {
+        if (m_allocations != 0)
+        {
+            Log::warn("Destruct called with allocations undeleted");
+        }
+
+        Area* area = m_areas;
+        while (area)
+        {
+            Area* next = area->next;
+            _aligned_free(area);
+            area = next;
+        }
+    }
+
+    void* TlsfMemoryPool::allocate(std::size_t size, std::size_t alignment_bits)
+    {
+        ERIS_TRACK_ALLOCATION(Type::TLSF, size);
+
+        ERIS_ASSERT(alignment_bits <= m_alignment_bits);
+        (void) alignment_bits;
+
+        if (size > MAX_BLOCK_SIZE)
+        {
+            Log::errorf("TLSF allocation of %llu bytes is too big", (glm::u64) size);
+            recordFailure();
+            return nullptr;
+        }
+
+        size = glm::max(getAlignedRoundUp(16, size), m_min_block_size);
+
+        std::lock_guard<SpinLock> lock(m_lock);
+
+        Block* block = findFreeBlock(size);
+        if (!block)
+        {
+            if (!createArea(size) || !(block = findFreeBlock(size)))
+            {
+                recordFailure();
+                return nullptr;
+            }
+        }
+
+        removeFreeBlock(block);
+        splitBlock(block, size);
+
+        block->size &= ~BLOCK_FREE;
+        getNextBlock(block)->size &= ~BLOCK_PREV_FREE;
+
+        recordAllocation(block->getSize());
+
+        return reinterpret_cast<glm::u8*>(block) + m_block_header_size;
+    }
+
+    void* TlsfMemoryPool::reallocate(void* ptr, std::size_t size)
+    {
+        if (!ptr)
+            return allocate(size, m_alignment_bits);
+
+        if (!size)
+        {
+            deallocate(ptr);
+            return nullptr;
+        }
+
+        Block* block = reinterpret_cast<Block*>(reinterpret_cast<glm::u8*>(ptr) - m_block_header_size);
+        std::size_t current = block->getSize();
+        if (current >= size)
+            return ptr;
+
+        void* out = allocate(size, m_alignment_bits);
+        if (out)
+        {
+            memcpy(out, ptr, current);
+            deallocate(ptr);
+        }
+
+        return out;
+    }
+
+    void TlsfMemoryPool::deallocate(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        Block* block = reinterpret_cast<Block*>(reinterpret_cast<glm::u8*>(ptr) - m_block_header_size);
+        ERIS_ASSERT(!block->isFree());
+
+        std::lock_guard<SpinLock> lock(m_lock);
+
+        recordDeallocation(block->getSize());
+
+        block->size |= BLOCK_FREE;
+
+        if (block->isPrevFree())
+        {
+            Block* prev = block->prev_physical;
+            ERIS_ASSERT(prev && prev->isFree());
+
+            removeFreeBlock(prev);
+            prev->size += m_block_header_size + block->getSize();
+            block = prev;
+        }
+
+        Block* next = getNextBlock(block);
+        if (next->isFree())
+        {
+            removeFreeBlock(next);
+            block->size += m_block_header_size + next->getSize();
+            next = getNextBlock(block);
+        }
+
+        next->prev_physical = block;
+        next->size |= BLOCK_PREV_FREE;
+
+        insertFreeBlock(block);
+    }
+
+    TlsfMemoryPool* TlsfMemoryPool::getDefault()
+    {
+        static std::atomic<TlsfMemoryPool*> s_default(nullptr);
+
+        TlsfMemoryPool* pool = s_default.load(std::memory_order_acquire);
+        if (!pool)
+        {
+            TlsfMemoryPool* created = new TlsfMemoryPool();
+            created->setName("Tlsf");
+            created->increment();
+
+            if (s_default.compare_exchange_strong(pool, created))
+                pool = created;
+            else
+                created->release();
+        }
+
+        return pool;
+    }
+
+    void TlsfMemoryPool::mapping(std::size_t size, glm::u32& fl, glm::u32& sl) const
+    {
+        if (size < SMALL_BLOCK_SIZE)
+        {
+            fl = 0;
+            sl = static_cast<glm::u32>(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+        }
+        else
+        {
+            glm::u32 last = static_cast<glm::u32>(findLastSet(size));
+            sl = static_cast<glm::u32>(size >> (last - SL_INDEX_COUNT_LOG2)) ^ (1 << SL_INDEX_COUNT_LOG2);
+            fl = last - (FL_INDEX_SHIFT - 1);
+        }
+    }
+
+    TlsfMemoryPool::Block* TlsfMemoryPool::findFreeBlock(std::size_t size)
+    {
+        // Round up to the next list so any block found is large enough.
+        if (size >= SMALL_BLOCK_SIZE)
+            size += (std::size_t(1) << (findLastSet(size) - SL_INDEX_COUNT_LOG2)) - 1;
+
+        glm::u32 fl, sl;
+        mapping(size, fl, sl);
+
+        if (fl >= FL_INDEX_COUNT)
+            return nullptr;
+
+        glm::u32 sl_map = m_sl_bitmap[fl] & (~0U << sl);
+        if (!sl_map)
+        {
+            glm::u32 fl_map = fl + 1 < FL_INDEX_COUNT ? m_fl_bitmap & (~0U << (fl + 1)) : 0;
+            if (!fl_map)
+                return nullptr;
+
+            fl = findFirstSet(fl_map);
+            sl_map = m_sl_bitmap[fl];
+        }
+
+        sl = findFirstSet(sl_map);
+
+        return m_blocks[fl][sl];
+    }
+
+    void TlsfMemoryPool::insertFreeBlock(Block* block)
+    {
+        glm::u32 fl, sl;
+        mapping(block->getSize(), fl, sl);
+
+        Block* head = m_blocks[fl][sl];
+        block->next_free = head;
+        block->prev_free = nullptr;
+        if (head)
+            head->prev_free = block;
+
+        m_blocks[fl][sl] = block;
+        m_fl_bitmap |= 1U << fl;
+        m_sl_bitmap[fl] |= 1U << sl;
+    }
+
+    void TlsfMemoryPool::removeFreeBlock(Block* block)
+    {
+        glm::u32 fl, sl;
+        mapping(block->getSize(), fl, sl);
+
+        if (block->prev_free)
+            block->prev_free->next_free = block->next_free;
+        if (block->next_free)
+            block->next_free->prev_free = block->prev_free;
+
+        if (m_blocks[fl][sl] == block)
+        {
+            m_blocks[fl][sl] = block->next_free;
+            if (!m_blocks[fl][sl])
+            {
+                m_sl_bitmap[fl] &= ~(1U << sl);
+                if (!m_sl_bitmap[fl])
+                    m_fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+
+    void TlsfMemoryPool::splitBlock(Block* block, std::size_t size)
+    {
+        std::size_t block_size = block->getSize();
+        if (block_size < size + m_block_header_size + m_min_block_size)
+            return;
+
+        Block* remaining = reinterpret_cast<Block*>(reinterpret_cast<glm::u8*>(block) + m_block_header_size + size);
+        remaining->prev_physical = block;
+        remaining->size = (block_size - size - m_block_header_size) | BLOCK_FREE;
+
+        block->size = size | (block->size & BLOCK_FLAGS);
+
+        Block* next = getNextBlock(remaining);
+        next->prev_physical = remaining;
+        next->size |= BLOCK_PREV_FREE;
+
+        insertFreeBlock(remaining);
+    }
+
+    TlsfMemoryPool::Block* TlsfMemoryPool::getNextBlock(Block* block) const
+    {
+        return reinterpret_cast<Block*>(reinterpret_cast<glm::u8*>(block) + m_block_header_size + block->getSize());
+    }
+
+    bool TlsfMemoryPool::createArea(std::size_t size)
+    {
+        // An area is one free block followed by an empty sentinel block that is never free.
+        std::size_t area_header_size = getAlignedRoundUp(16, sizeof(Area));
+        std::size_t area_size = glm::max(m_area_size, area_header_size + m_block_header_size * 2 + size + (size >> SL_INDEX_COUNT_LOG2));
+        area_size = getAlignedRoundUp(16, area_size);
+
+        glm::u8* memory = reinterpret_cast<glm::u8*>(_aligned_malloc(area_size, 16));
+        if (!memory)
+        {
+            Log::error("Not enough memory for allocation");
+            return false;
+        }
+
+        Area* area = reinterpret_cast<Area*>(memory);
+        area->next = m_areas;
+        m_areas = area;
+
+        Block* block = reinterpret_cast<Block*>(memory + area_header_size);
+        block->prev_physical = nullptr;
+        block->size = (area_size - area_header_size - m_block_header_size * 2) | BLOCK_FREE;
+
+        Block* sentinel = getNextBlock(block);
+        sentinel->prev_physical = block;
+        sentinel->size = BLOCK_PREV_FREE;
+
+        insertFreeBlock(block);
+        recordChunks(1);
+
+        return true;
+    }
 }
\ No newline at end of file
@@ -23,13 +23,34 @@
 #pragma once
 
 #include "RefCounted.h"
+#include "Thread/AdaptiveLock.h"
 #include "Thread/SpinLock.h"
 #include "Util/NonCopyable.h"
 
 #include <atomic>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace Eris
 {
+    static const std::size_t STACK_COMMIT_SIZE = 64 * 1024;
+
+    static const std::size_t SLAB_SIZE = 64 * 1024;
+    static const std::size_t SLAB_GRANULARITY = 16;
+    static const std::size_t SLAB_MAX_BLOCK_SIZE = 512;
+    static const glm::u32 SLAB_SIZE_CLASSES = SLAB_MAX_BLOCK_SIZE / SLAB_GRANULARITY;
+    static const glm::u32 SLAB_MAGAZINE_SIZE = 32;
+    /// Bytes a magazine holds at most, so the large size classes keep fewer blocks per thread.
+    static const std::size_t SLAB_MAGAZINE_BYTES = 4 * 1024;
+    /// Address space slabs are committed from, deallocate tells slab blocks from large ones by it.
+    static const std::size_t SLAB_ARENA_SIZE = 16 * 1024 * 1024;
+    static const glm::u32 SLAB_MAX_ARENAS = 64;
+    static const glm::u32 SLAB_MAX_THREADS = 32;
+    static const glm::u32 CHAIN_MAX_THREADS = 32;
+
+    static const std::size_t TLSF_AREA_SIZE = 1024 * 1024;
+
     class BaseMemoryPool : public RefCounted, public NonCopyable
     {
     public:
@@ -38,22 +59,105 @@ namespace Eris
             NONE,
             HEAP,
             STACK,
-            CHAIN
+            CHAIN,
+            FRAME,
+            SLAB,
+            TLSF
+        };
+
+        struct Stats
+        {
+            std::string name;
+            Type type = Type::NONE;
+            std::size_t used_size = 0;
+            std::size_t peak_size = 0;
+            std::size_t chunks = 0;
+            glm::u32 allocations = 0;
+            glm::u32 frame_allocations = 0;
+            glm::u32 frame_deallocations = 0;
+            glm::u32 frame_failed_allocations = 0;
+            glm::u32 failed_allocations = 0;
         };
 
         BaseMemoryPool(Type type);
-        virtual ~BaseMemoryPool() {}
+        virtual ~BaseMemoryPool();
 
         void* allocate(std::size_t size, std::size_t alignment_bits);
         void deallocate(void* ptr);
 
+        void setName(const std::string& name) { m_name = name; }
+
+        const std::string& getName() const { return m_name; }
+        Type getType() const { return m_type; }
+        glm::u32 getHandle() const { return m_handle; }
         glm::u32 getAllocations() const { return m_allocations.load(); }
+        std::size_t getUsedSize() const { return m_used_size.load(); }
+        std::size_t getPeakSize() const { return m_peak_size.load(); }
+        std::size_t getChunks() const { return m_chunks.load(); }
+        glm::u32 getFailedAllocations() const { return m_failed_allocations.load(); }
+
+        Stats getStats() const;
+        void resetFrameStats();
 
     protected:
+        void recordAllocation(std::size_t size);
+        void recordDeallocation(std::size_t size, glm::u32 count = 1);
+        void recordFailure();
+        void recordChunks(glm::i32 count);
+
         std::atomic<glm::u32> m_allocations;
 
     private:
         Type m_type;
+        glm::u32 m_handle;
+        std::string m_name;
+        std::atomic<std::size_t> m_used_size;
+        std::atomic<std::size_t> m_peak_size;
+        std::atomic<std::size_t> m_chunks;
+        std::atomic<glm::u32> m_frame_allocations;
+        std::atomic<glm::u32> m_frame_deallocations;
+        std::atomic<glm::u32> m_frame_failed_allocations;
+        std::atomic<glm::u32> m_failed_allocations;
+    };
+
+    static const glm::u16 MEMORY_POOL_MAX = 1024;
+    static const glm::u32 MEMORY_POOL_INVALID = 0xFFFFFFFF;
+
+    class MemoryPoolRegistry
+    {
+    public:
+        /// Returns the slot the pool was placed in, with the slot's generation in the upper 16 bits so a handle
+        /// outliving its pool never reaches the next one. MEMORY_POOL_INVALID if the registry is full.
+        static glm::u32 add(BaseMemoryPool* pool);
+        static void remove(BaseMemoryPool* pool);
+
+        /// Aborts in every build on a handle that is invalid or whose pool is gone.
+        static BaseMemoryPool* getPool(glm::u32 handle)
+        {
+            glm::u32 slot = handle & 0xFFFF;
+            if (slot >= MEMORY_POOL_MAX || s_generations[slot] != handle >> 16)
+                invalidHandle(handle);
+
+            return s_pools[slot];
+        }
+
+        static std::vector<BaseMemoryPool::Stats> getStats();
+        static std::vector<BaseMemoryPool::Stats> getFrameReport();
+
+        /// Bytes in use across every pool, without allocating.
+        static std::size_t getUsedSize();
+
+        /// Thread exit callback, returns what the pools cached for the thread.
+        static void releaseThread(glm::u32 thread);
+
+        /// Snapshot every pool into the frame report and start counting the next frame.
+        static void endFrame();
+
+    private:
+        static void invalidHandle(glm::u32 handle);
+
+        static BaseMemoryPool* s_pools[MEMORY_POOL_MAX];
+        static glm::u16 s_generations[MEMORY_POOL_MAX];
     };
 
     class HeapMemoryPool : public BaseMemoryPool
@@ -64,21 +168,38 @@ namespace Eris
 
         void* allocate(std::size_t size, std::size_t alignment_bits);
         void deallocate(void* ptr);
+
+    private:
+        struct MemoryBlockHeader
+        {
+            std::size_t size;
+            std::size_t offset;
+        };
     };
 
     class StackMemoryPool : public BaseMemoryPool
     {
-        using Snapshot = void*;
-
     public:
-        StackMemoryPool(std::size_t size, bool deallocation_flag = false, std::size_t alignment_bits = 16);
+        struct Snapshot
+        {
+            glm::u8* head;
+            std::size_t used_size;
+            glm::u32 allocations;
+        };
+
+        /// With the virtual flag set, size is only reserved and pages are committed as the stack grows into them.
+        StackMemoryPool(std::size_t size, bool deallocation_flag = false, std::size_t alignment_bits = 16, bool virtual_flag = false);
         virtual ~StackMemoryPool() final;
 
         void* allocate(std::size_t size, std::size_t alignment_bits);
         void deallocate(void* ptr);
 
+        void setDecommitOnReset(bool decommit) { m_decommit_flag = decommit; }
+
         std::size_t getTotalSize() const { return m_mem_size; }
         std::size_t getAllocatedSize() const { return m_head.load() - m_memory; }
+        std::size_t getCommittedSize() const { return m_committed.load() - m_memory; }
+        bool isVirtual() const { return m_virtual_flag; }
 
         Snapshot takeSnapshot() const;
 
@@ -91,11 +212,17 @@ namespace Eris
             glm::u8 size[sizeof(std::size_t)];
         };
 
+        bool commit(glm::u8* end);
+
         bool m_deallocation_flag;
+        bool m_virtual_flag;
+        bool m_decommit_flag;
         std::size_t m_alignment_bits;
         std::size_t m_header_size;
         std::size_t m_mem_size;
         std::atomic<glm::u8*> m_head;
+        std::atomic<glm::u8*> m_committed;
+        SpinLock m_commit_lock;
         glm::u8* m_memory;
     };
 
@@ -119,28 +246,267 @@ namespace Eris
         std::size_t getChunksCount() const;
         std::size_t getAllocatedSize() const;
 
+        /// Gives up the tail chunk of an exited thread, it is freed once its blocks are.
+        void releaseThread(glm::u32 thread);
+
     private:
+        static const glm::u32 SHARED_TAIL = CHAIN_MAX_THREADS;
+
         struct Chunk
         {
             glm::u8* memory = nullptr;
             std::size_t mem_size = 0;
             glm::u8* head = nullptr;
-            std::size_t allocation_count = 0;
+            std::atomic<std::size_t> allocation_count;
+            Chunk* prev = nullptr;
             Chunk* next = nullptr;
         };
 
-        std::size_t computeChunkSize(std::size_t size);
+        struct MemoryBlockHeader
+        {
+            Chunk* chunk;
+            std::size_t size;
+        };
+
+        void* allocateFromTail(Chunk*& tail, std::size_t size);
+        std::size_t computeChunkSize(Chunk* tail, std::size_t size);
         Chunk* createChunk(std::size_t size);
-        void* allocateFromChunk(Chunk* ch, std::size_t size, std::size_t alignment_bits);
+        void* allocateFromChunk(Chunk* ch, std::size_t size);
+        void releaseChunk(Chunk* ch);
         void destroyChunk(Chunk* chunk);
 
         std::size_t m_alignment_bits;
+        std::size_t m_header_size;
         std::size_t m_init_size;
         std::size_t m_max_size;
         std::size_t m_step;
         ChunkGrowMethod m_method;
-        SpinLock m_lock;
+        AdaptiveLock m_lock;
+        AdaptiveLock m_tail_lock;
         Chunk* m_head_chunk;
-        Chunk* m_tail_chunk;
+        Chunk* m_tails[CHAIN_MAX_THREADS + 1];
+        /// Bytes bumped in live chunks. Chunk heads move without the lock, so they are only summed here.
+        std::atomic<std::size_t> m_allocated_size;
     };
+
+    class FrameMemoryPool : public BaseMemoryPool
+    {
+        using DestructorFunction = void(*)(void*);
+
+    public:
+        FrameMemoryPool(std::size_t frame_size, glm::u32 frames = 2, std::size_t alignment_bits = 16);
+        virtual ~FrameMemoryPool() final;
+
+        void* allocate(std::size_t size, std::size_t alignment_bits);
+        void deallocate(void* ptr);
+
+        template<typename T, typename... Args>
+        T* newInstance(Args&&... args);
+
+        /// Advance to the next frame, recycling the oldest frame in flight.
+        void nextFrame();
+
+        glm::u32 getFrames() const { return m_frames_count; }
+        glm::u32 getCurrentFrame() const { return m_current.load(); }
+        std::size_t getLastFrameSize() const { return m_last_frame_size; }
+        std::size_t getHighWaterMark() const { return m_high_water_mark; }
+
+    private:
+        struct Block
+        {
+            glm::u8* memory = nullptr;
+            glm::u8* end = nullptr;
+            std::atomic<glm::u8*> head;
+            Block* next = nullptr;
+        };
+
+        struct Destructor
+        {
+            DestructorFunction function;
+            void* object;
+            Destructor* next;
+        };
+
+        struct Frame
+        {
+            Block* first = nullptr;
+            std::atomic<Block*> current;
+            std::atomic<Destructor*> destructors;
+            std::atomic<std::size_t> size;
+            std::atomic<glm::u32> allocations;
+        };
+
+        template<typename T>
+        static void destroyInstance(void* ptr)
+        {
+            reinterpret_cast<T*>(ptr)->~T();
+        }
+
+        Frame& getFrame() { return m_frames[m_current.load()]; }
+
+        void* allocateFromFrame(Frame& frame, std::size_t size, std::size_t alignment_bits);
+        void addDestructor(Frame& frame, void* object, DestructorFunction function);
+        void recycleFrame(Frame& frame);
+
+        Block* createBlock(std::size_t size);
+        void destroyBlocks(Block* block);
+
+        std::size_t m_alignment_bits;
+        std::size_t m_header_size;
+        std::size_t m_frame_size;
+        std::size_t m_last_frame_size;
+        std::size_t m_high_water_mark;
+        glm::u32 m_frames_count;
+        std::atomic<glm::u32> m_current;
+        SpinLock m_lock;
+        Frame* m_frames;
+    };
+
+    template<typename T, typename... Args>
+    inline T* FrameMemoryPool::newInstance(Args&&... args)
+    {
+        Frame& frame = getFrame();
+
+        T* ptr = reinterpret_cast<T*>(allocateFromFrame(frame, sizeof(T), __alignof(T)));
+        if (ptr)
+        {
+            ::new (reinterpret_cast<void*>(ptr)) T(std::forward<Args>(args)...);
+
+            if (!std::is_trivially_destructible<T>::value)
+                addDestructor(frame, ptr, &FrameMemoryPool::destroyInstance<T>);
+        }
+
+        return ptr;
+    }
+
+    class SlabMemoryPool : public BaseMemoryPool
+    {
+    public:
+        SlabMemoryPool(std::size_t slab_size = SLAB_SIZE, std::size_t alignment_bits = 16);
+        virtual ~SlabMemoryPool() final;
+
+        void* allocate(std::size_t size, std::size_t alignment_bits);
+        void deallocate(void* ptr);
+
+        std::size_t getSlabsCount() const { return getStats().chunks; }
+
+        /// Hands the magazines of an exited thread back to the shared free lists.
+        void releaseThread(glm::u32 thread);
+
+        static SlabMemoryPool* getDefault();
+
+    private:
+        static const glm::u32 LARGE_CLASS = SLAB_SIZE_CLASSES;
+
+        struct Slab
+        {
+            glm::u32 size_class;
+            std::size_t size;
+        };
+
+        struct Block
+        {
+            Block* next;
+        };
+
+        struct SizeClass
+        {
+            std::size_t block_size = 0;
+            glm::u32 magazine_size = 0;
+            Block* free = nullptr;
+            SpinLock lock;
+        };
+
+        struct Magazine
+        {
+            glm::u32 count = 0;
+            Block* blocks[SLAB_MAGAZINE_SIZE];
+        };
+
+        Magazine* getMagazines();
+        glm::u32 popBlocks(glm::u32 size_class, Block** out, glm::u32 count);
+        void pushBlocks(glm::u32 size_class, Block** in, glm::u32 count);
+        bool createSlab(SizeClass& size_class, glm::u32 index);
+        glm::u8* commitSlab();
+        bool ownsSlab(const void* ptr) const;
+        void* allocateLarge(std::size_t size);
+
+        std::size_t m_slab_size;
+        std::size_t m_alignment_bits;
+        std::size_t m_header_size;
+        SizeClass m_classes[SLAB_SIZE_CLASSES];
+        std::atomic<Magazine*> m_magazines[SLAB_MAX_THREADS];
+        std::atomic<glm::u8*> m_arenas[SLAB_MAX_ARENAS];
+        glm::u8* m_arena_reservations[SLAB_MAX_ARENAS];
+        std::atomic<glm::u32> m_arena_count;
+        std::size_t m_arena_used;
+        SpinLock m_arena_lock;
+    };
+
+    class TlsfMemoryPool : public BaseMemoryPool
+    {
+    public:
+        TlsfMemoryPool(std::size_t area_size = TLSF_AREA_SIZE, std::size_t alignment_bits = 16);
+        virtual ~TlsfMemoryPool() final;
+
+        void* allocate(std::size_t size, std::size_t alignment_bits);
+        void* reallocate(void* ptr, std::size_t size);
+        void deallocate(void* ptr);
+
+        static TlsfMemoryPool* getDefault();
+
+    private:
+        static const glm::u32 SL_INDEX_COUNT_LOG2 = 5;
+        static const glm::u32 SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2;
+        static const glm::u32 FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + 4;
+        static const glm::u32 FL_INDEX_MAX = 32;
+        static const glm::u32 FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+        static const std::size_t SMALL_BLOCK_SIZE = 1 << FL_INDEX_SHIFT;
+        /// Largest request whose block, and the area made for it, still map below FL_INDEX_COUNT.
+        static const std::size_t MAX_BLOCK_SIZE = std::size_t(1) << (FL_INDEX_MAX - 1);
+
+        static const std::size_t BLOCK_FREE = 1;
+        static const std::size_t BLOCK_PREV_FREE = 2;
+        static const std::size_t BLOCK_FLAGS = BLOCK_FREE | BLOCK_PREV_FREE;
+
+        struct Area
+        {
+            Area* next;
+        };
+
+        // Free list links overlay the first bytes of a free block's payload.
+        struct Block
+        {
+            Block* prev_physical;
+            std::size_t size;
+            Block* next_free;
+            Block* prev_free;
+
+            std::size_t getSize() const { return size & ~BLOCK_FLAGS; }
+            bool isFree() const { return (size & BLOCK_FREE) != 0; }
+            bool isPrevFree() const { return (size & BLOCK_PREV_FREE) != 0; }
+        };
+
+        void mapping(std::size_t size, glm::u32& fl, glm::u32& sl) const;
+        Block* findFreeBlock(std::size_t size);
+        void insertFreeBlock(Block* block);
+        void removeFreeBlock(Block* block);
+        void splitBlock(Block* block, std::size_t size);
+        Block* getNextBlock(Block* block) const;
+        bool createArea(std::size_t size);
+
+        std::size_t m_area_size;
+        std::size_t m_alignment_bits;
+        std::size_t m_block_header_size;
+        std::size_t m_min_block_size;
+        SpinLock m_lock;
+        Area* m_areas;
+        glm::u32 m_fl_bitmap;
+        glm::u32 m_sl_bitmap[FL_INDEX_COUNT];
+        Block* m_blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+    };
+
+#define SLAB_ALLOCATED \
+    static void* operator new (std::size_t size) { return Eris::SlabMemoryPool::getDefault()->allocate(size, 16); } \
+    static void operator delete (void* ptr) { Eris::SlabMemoryPool::getDefault()->deallocate(ptr); }
 }
\ No newline at end of file
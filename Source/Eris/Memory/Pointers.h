@@ -125,27 +125,27 @@ namespace Eris
     public:
         WeakPtr() :
             m_ptr(nullptr),
-            m_ref_count(nullptr)
+            m_counts(nullptr)
         {
         }
 
         WeakPtr(const WeakPtr<T>& rhs) :
             m_ptr(rhs.m_ptr),
-            m_ref_count(rhs.m_ref_count)
+            m_counts(rhs.m_counts)
         {
             incrementRef();
         }
         
         WeakPtr(const SharedPtr<T>& rhs) :
             m_ptr(rhs.get()),
-            m_ref_count(rhs.m_ptr->m_ref_count)
+            m_counts(getCounts(rhs.get()))
         {
             incrementRef();
         }
 
         explicit WeakPtr(T* ptr) :
             m_ptr(ptr),
-            m_ref_count(ptr ? ptr->m_ref_count : nullptr)
+            m_counts(getCounts(ptr))
         {
             incrementRef();
         }
@@ -157,12 +157,12 @@ namespace Eris
 
         WeakPtr<T>& operator = (const SharedPtr<T>& rhs)
         {
-            if (m_ptr == rhs.m_ptr)
+            if (m_ptr == rhs.get())
                 return *this;
 
             releaseRef();
             m_ptr = rhs.get();
-            m_ref_count = m_ptr->m_ref_count;
+            m_counts = getCounts(m_ptr);
             incrementRef();
 
             return *this;
@@ -175,20 +175,20 @@ namespace Eris
 
             releaseRef();
             m_ptr = rhs.m_ptr;
-            m_ref_count = rhs.m_ref_count;
+            m_counts = rhs.m_counts;
             incrementRef();
 
             return *this;
         }
 
-        WeakPtr<T>& operator = (const T* ptr)
+        WeakPtr<T>& operator = (T* ptr)
         {
             if (m_ptr == ptr)
                 return *this;
 
             releaseRef();
             m_ptr = ptr;
-            m_ref_count = ptr ? ptr->m_ref_count : nullptr;
+            m_counts = getCounts(ptr);
             incrementRef();
 
             return *this;
@@ -231,8 +231,8 @@ namespace Eris
             return raw[index];
         }
 
-        bool operator == (const WeakPtr<T>& rhs) const { return m_ptr == rhs.m_ptr && m_ref_count == rhs.m_ref_count; }
-        bool operator != (const WeakPtr<T>& rhs) const { return m_ptr != rhs.m_ptr && m_ref_count != rhs.m_ref_count; }
+        bool operator == (const WeakPtr<T>& rhs) const { return m_ptr == rhs.m_ptr && m_counts == rhs.m_counts; }
+        bool operator != (const WeakPtr<T>& rhs) const { return m_ptr != rhs.m_ptr && m_counts != rhs.m_counts; }
         bool operator < (const WeakPtr<T>& rhs) const { return m_ptr < rhs.m_ptr; }
         bool operator > (const WeakPtr<T>& rhs) const { return m_ptr > rhs.m_ptr; }
         bool operator >= (const WeakPtr<T>& rhs) const { return m_ptr >= rhs.m_ptr; }
@@ -244,39 +244,36 @@ namespace Eris
 
         void reset() { releaseRef(); }
 
-        bool isNull() const { return m_ref_count == nullptr; }
-        bool isExpired() const { return m_ref_count ? m_ref_count->m_refs < 0 : true; }
-        glm::i32 getRefs() const { return m_ref_count ? m_ref_count->m_refs : 0; }
-        glm::i32 getWeakRefs() const { return m_ref_count ? m_ref_count->m_weak_refs : 0; }
+        bool isNull() const { return m_counts == nullptr; }
+        bool isExpired() const { return m_counts ? RefCounted::isExpired(m_counts) : true; }
+        glm::i32 getRefs() const { return m_counts ? m_counts->refs.load() : 0; }
+        glm::i32 getWeakRefs() const { return m_counts ? m_counts->weak_refs.load() : 0; }
 
     private:
         template<typename U> WeakPtr<T> operator = (const WeakPtr<U>& rhs) = delete;
 
+        static RefCounted::Counts* getCounts(RefCounted* counted)
+        {
+            return counted ? counted->m_counts : nullptr;
+        }
+
         void incrementRef()
         {
-            if (m_ref_count)
-            {
-                ERIS_ASSERT(m_ref_count->m_weak_refs >= 0);
-                m_ref_count->m_weak_refs++;
-            }
+            if (m_counts)
+                RefCounted::incrementWeak(m_counts);
         }
 
         void releaseRef()
         {
-            if (m_ref_count)
-            {
-                ERIS_ASSERT(m_ref_count);
-                m_ref_count->m_weak_refs--;
-
-                if (isExpired() && !m_ref_count->m_weak_refs)
-                    delete m_ref_count;
-            }
+            // Only the counts are touched, the last weak reference to an expired object releases its storage.
+            if (m_counts)
+                RefCounted::releaseWeak(m_counts);
 
             m_ptr = nullptr;
-            m_ref_count = nullptr;
+            m_counts = nullptr;
         }
 
         T* m_ptr;
-        RefCounter* m_ref_count;
+        RefCounted::Counts* m_counts;
     };
 }
\ No newline at end of file
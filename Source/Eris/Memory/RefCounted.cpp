@@ -21,51 +21,113 @@
 //
 
 #include "RefCounted.h"
+#include "Memory.h"
+
+#include "Thread/Types.h"
 
 namespace Eris
 {
+    void* RefCounter::operator new (std::size_t size)
+    {
+        return SlabMemoryPool::getDefault()->allocate(size, __alignof(RefCounter));
+    }
+
+    void RefCounter::operator delete (void* ptr)
+    {
+        SlabMemoryPool::getDefault()->deallocate(ptr);
+    }
+
+    /// Room for the counts in front of an object, keeping the object 16 byte aligned.
+    static const std::size_t REF_COUNT_HEADER_SIZE = 16;
+
+    /// Storage operator new last handed out on this thread, the first RefCounted constructed in it takes its header.
+    static ERIS_THREAD_LOCAL glm::u8* t_new_object = nullptr;
+    static ERIS_THREAD_LOCAL std::size_t t_new_size = 0;
+
+    RefCounted::RefCounted(RefCountPolicy policy) :
+        m_counts(createCounts(this, policy))
+    {
+    }
 
-    RefCounted::RefCounted() :
-        m_ref_count(new RefCounter())
+    RefCounted::RefCounted(const RefCounted& rhs) :
+        m_counts(createCounts(this, rhs.m_counts->policy))
     {
-        m_ref_count->m_weak_refs++;
     }
 
     RefCounted::~RefCounted()
     {
-        ERIS_ASSERT(m_ref_count);
-        ERIS_ASSERT(m_ref_count->m_refs == 0);
-        ERIS_ASSERT(m_ref_count->m_weak_refs > 0);
+        ERIS_ASSERT(m_counts->refs == 0);
 
-        m_ref_count->m_refs = -1;
-        m_ref_count->m_weak_refs--;
-        if (!m_ref_count->m_weak_refs)
-            delete m_ref_count;
+        m_counts->refs = -1;
 
-        m_ref_count = nullptr;
+        // A header from operator new is released by operator delete, after the whole object is destroyed.
+        if (m_counts->storage == Storage::SEPARATE)
+            releaseWeak(m_counts);
     }
 
-    void RefCounted::increment()
+    void* RefCounted::operator new (std::size_t size)
     {
-        ERIS_ASSERT(m_ref_count->m_refs >= 0);
-        m_ref_count->m_refs++;
+        // The default slab pool is itself ref counted, so it has to come from the heap, as do objects too big for a slab.
+        SlabMemoryPool* pool = SlabMemoryPool::getDefault();
+        std::size_t block_size = REF_COUNT_HEADER_SIZE + size;
+        bool pooled = pool && block_size <= SLAB_MAX_BLOCK_SIZE;
+
+        glm::u8* block = static_cast<glm::u8*>(pooled ? pool->allocate(block_size, 16) : _aligned_malloc(block_size, 16));
+        ERIS_ASSERT(block);
+
+        Counts* counts = reinterpret_cast<Counts*>(block);
+        counts->refs = 0;
+        counts->weak_refs = 1;
+        counts->policy = RefCountPolicy::ATOMIC;
+        counts->storage = pooled ? Storage::POOL : Storage::HEAP;
+
+        t_new_object = block + REF_COUNT_HEADER_SIZE;
+        t_new_size = size;
+
+        return t_new_object;
     }
 
-    void RefCounted::release()
+    void RefCounted::operator delete (void* ptr)
     {
-        ERIS_ASSERT(m_ref_count->m_refs > 0);
-        m_ref_count->m_refs--;
-        if (!m_ref_count->m_refs)
-            delete this;
+        // Destruction is done, the storage goes with the header once no WeakPtr is left.
+        releaseWeak(reinterpret_cast<Counts*>(static_cast<glm::u8*>(ptr) - REF_COUNT_HEADER_SIZE));
     }
 
-    glm::i32 RefCounted::getRefs()
+    void RefCounted::releaseWeak(Counts* counts)
     {
-        return m_ref_count->m_refs;
+        ERIS_ASSERT(counts->weak_refs > 0);
+        if (add(counts, counts->weak_refs, -1))
+            return;
+
+        if (counts->storage == Storage::POOL)
+            SlabMemoryPool::getDefault()->deallocate(counts);
+        else
+            _aligned_free(counts);
     }
 
-    glm::i32 RefCounted::getWeakRefs()
+    RefCounted::Counts* RefCounted::createCounts(RefCounted* object, RefCountPolicy policy)
     {
-        return m_ref_count->m_weak_refs - 1;
+        glm::u8* address = reinterpret_cast<glm::u8*>(object);
+        Counts* counts;
+
+        if (t_new_object && address >= t_new_object && address < t_new_object + t_new_size)
+        {
+            counts = reinterpret_cast<Counts*>(t_new_object - REF_COUNT_HEADER_SIZE);
+            t_new_object = nullptr;
+        }
+        else
+        {
+            // Objects on the stack, inside other objects or from another operator new
+            counts = static_cast<Counts*>(_aligned_malloc(sizeof(Counts), __alignof(Counts)));
+            ERIS_ASSERT(counts);
+
+            counts->refs = 0;
+            counts->weak_refs = 1;
+            counts->storage = Storage::SEPARATE;
+        }
+
+        counts->policy = policy;
+
+        return counts;
     }
 }
\ No newline at end of file
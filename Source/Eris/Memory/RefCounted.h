@@ -28,6 +28,12 @@
 
 namespace Eris
 {
+    enum class RefCountPolicy : glm::u8
+    {
+        ATOMIC,
+        LOCAL
+    };
+
     struct RefCounter
     {
         RefCounter() :
@@ -42,27 +48,89 @@ namespace Eris
             m_weak_refs = -1;
         }
 
+        static void* operator new (std::size_t size);
+        static void operator delete (void* ptr);
+
         std::atomic<glm::i32> m_refs;
         std::atomic<glm::i32> m_weak_refs;
     };
 
+    /// Counts live in a header in front of objects created with new, objects built elsewhere get a separate one.
+    /// Once the last strong reference goes the object is destroyed, but the header and the object's storage are kept
+    /// until the last WeakPtr lets go of them, so weak references never touch a destroyed object.
     class RefCounted : public Aligned<>
     {
         template<typename T> 
         friend class WeakPtr;
 
     public:
-        RefCounted();
+        RefCounted(RefCountPolicy policy = RefCountPolicy::ATOMIC);
+        RefCounted(const RefCounted& rhs);
         virtual ~RefCounted();
 
-        void increment();
-        void release();
+        RefCounted& operator = (const RefCounted& rhs) { (void) rhs; return *this; }
 
-        glm::i32 getRefs();
-        glm::i32 getWeakRefs();
+        void increment()
+        {
+            ERIS_ASSERT(m_counts->refs >= 0);
+            add(m_counts, m_counts->refs, 1);
+        }
+
+        void release()
+        {
+            ERIS_ASSERT(m_counts->refs > 0);
+            if (!add(m_counts, m_counts->refs, -1))
+                delete this;
+        }
+
+        glm::i32 getRefs() const { return m_counts->refs; }
+        glm::i32 getWeakRefs() const { return m_counts->weak_refs - 1; }
+
+        RefCountPolicy getRefCountPolicy() const { return m_counts->policy; }
+
+        static void* operator new (std::size_t size);
+        static void operator delete (void* ptr);
 
     private:
-        RefCounter* m_ref_count;
-    };
-}
+        enum class Storage : glm::u8
+        {
+            SEPARATE,
+            POOL,
+            HEAP
+        };
+
+        struct Counts
+        {
+            std::atomic<glm::i32> refs;
+            std::atomic<glm::i32> weak_refs;
+            RefCountPolicy policy;
+            Storage storage;
+        };
+
+        static glm::i32 add(Counts* counts, std::atomic<glm::i32>& count, glm::i32 value)
+        {
+            // Local counts are only touched by one thread, so skip the locked instruction.
+            if (counts->policy == RefCountPolicy::LOCAL)
+            {
+                glm::i32 result = count.load(std::memory_order_relaxed) + value;
+                count.store(result, std::memory_order_relaxed);
+                return result;
+            }
+
+            return count.fetch_add(value) + value;
+        }
 
+        static void incrementWeak(Counts* counts)
+        {
+            ERIS_ASSERT(counts->weak_refs > 0);
+            add(counts, counts->weak_refs, 1);
+        }
+
+        static void releaseWeak(Counts* counts);
+        static bool isExpired(const Counts* counts) { return counts->refs < 0; }
+
+        static Counts* createCounts(RefCounted* object, RefCountPolicy policy);
+
+        Counts* m_counts;
+    };
+}
\ No newline at end of file
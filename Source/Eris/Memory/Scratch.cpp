@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Scratch.h"
+
+namespace Eris
+{
+    StackMemoryPool* getScratchPool()
+    {
+        // Scratch pools live as long as the process, thread local storage cannot run destructors here.
+        static ERIS_THREAD_LOCAL StackMemoryPool* t_scratch = nullptr;
+
+        if (!t_scratch)
+        {
+            t_scratch = new StackMemoryPool(SCRATCH_SIZE, true, 16, true);
+            t_scratch->setName("Scratch");
+            t_scratch->increment();
+        }
+
+        return t_scratch;
+    }
+
+    ScratchScope::ScratchScope() :
+        m_pool(getScratchPool()),
+        m_snapshot(m_pool->takeSnapshot())
+    {
+    }
+
+    ScratchScope::~ScratchScope()
+    {
+        m_pool->resetUsingSnapshot(m_snapshot);
+    }
+
+    void* ScratchScope::allocate(std::size_t size, std::size_t alignment_bits)
+    {
+        return m_pool->allocate(size, alignment_bits);
+    }
+}
\ No newline at end of file
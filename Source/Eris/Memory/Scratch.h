@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Allocator.h"
+#include "Memory.h"
+
+#include "Util/NonCopyable.h"
+
+namespace Eris
+{
+    static const std::size_t SCRATCH_SIZE = 64 * 1024 * 1024;
+
+    template<typename T>
+    using ScratchAllocator = GenericPoolAllocator<T, StackMemoryPool>;
+
+    /// Per-thread bump allocator for temporaries. Reserved up front, committed as it is used.
+    StackMemoryPool* getScratchPool();
+
+    /// Everything allocated from the calling thread's scratch pool while the scope is alive is released when it exits.
+    class ScratchScope : public NonCopyable
+    {
+    public:
+        ScratchScope();
+        ~ScratchScope();
+
+        void* allocate(std::size_t size, std::size_t alignment_bits = 16);
+
+        template<typename T>
+        T* allocateArray(std::size_t count)
+        {
+            return reinterpret_cast<T*>(allocate(sizeof(T) * count, glm::max<std::size_t>(__alignof(T), 16)));
+        }
+
+        template<typename T>
+        ScratchAllocator<T> getAllocator() const
+        {
+            return ScratchAllocator<T>(m_pool);
+        }
+
+        StackMemoryPool* getPool() const { return m_pool; }
+
+    private:
+        StackMemoryPool* m_pool;
+        StackMemoryPool::Snapshot m_snapshot;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,330 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tracking.h"
+#include "Memory.h"
+
+#include "Core/Log.h"
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace Eris
+{
+    namespace
+    {
+        // Everything here is constant initialised and never allocates, operator new can reach it before static constructors run.
+        std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+        AllocationSite s_sites[ALLOCATION_SITES_MAX];
+        glm::u32 s_dropped_sites = 0;
+        glm::u64 s_frame_deallocations = 0;
+        glm::u64 s_last_frame_deallocations = 0;
+        glm::u32 s_violations = 0;
+        bool s_zero_allocation_mode = false;
+
+        ERIS_THREAD_LOCAL const char* t_scope = nullptr;
+        ERIS_THREAD_LOCAL bool t_suspended = false;
+
+        class TrackerLock
+        {
+        public:
+            TrackerLock() { while (s_lock.test_and_set(std::memory_order_acquire)) {} }
+            ~TrackerLock() { s_lock.clear(std::memory_order_release); }
+        };
+
+        /// Allocations made by the tracker itself while logging are not recorded.
+        class TrackerSuspend
+        {
+        public:
+            TrackerSuspend() : m_previous(t_suspended) { t_suspended = true; }
+            ~TrackerSuspend() { t_suspended = m_previous; }
+
+        private:
+            bool m_previous;
+        };
+
+        glm::u32 hashSite(const void* address, const char* scope, glm::u8 source)
+        {
+            glm::u64 key = reinterpret_cast<glm::u64>(address) ^ (reinterpret_cast<glm::u64>(scope) * 31) ^ source;
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return static_cast<glm::u32>(key) & (ALLOCATION_SITES_MAX - 1);
+        }
+
+        bool isFrameSafe(glm::u8 source)
+        {
+            return source == static_cast<glm::u8>(BaseMemoryPool::Type::FRAME) || source == static_cast<glm::u8>(BaseMemoryPool::Type::STACK);
+        }
+
+        const char* getSourceName(glm::u8 source)
+        {
+            if (source == ALLOCATION_SOURCE_GLOBAL)
+                return "new";
+
+            switch (static_cast<BaseMemoryPool::Type>(source))
+            {
+            case BaseMemoryPool::Type::HEAP:
+                return "Heap";
+            case BaseMemoryPool::Type::STACK:
+                return "Stack";
+            case BaseMemoryPool::Type::CHAIN:
+                return "Chain";
+            case BaseMemoryPool::Type::FRAME:
+                return "Frame";
+            case BaseMemoryPool::Type::SLAB:
+                return "Slab";
+            case BaseMemoryPool::Type::TLSF:
+                return "Tlsf";
+            default:
+                return "Unknown";
+            }
+        }
+
+        void logSite(const AllocationSite& site)
+        {
+            Log::rawf("\t%-6s %-24s %p: %u allocs %llu bytes last frame, %llu allocs %llu bytes total",
+                getSourceName(site.source), site.scope ? site.scope : "-", site.address,
+                site.last_frame_allocations, site.last_frame_bytes, site.total_allocations, site.total_bytes);
+        }
+    }
+
+    static_assert((ALLOCATION_SITES_MAX & (ALLOCATION_SITES_MAX - 1)) == 0, "ALLOCATION_SITES_MAX must be a power of two");
+
+    void AllocationTracker::recordAllocation(const void* address, glm::u8 source, std::size_t size)
+    {
+        if (t_suspended)
+            return;
+
+        const char* scope = t_scope;
+        glm::u32 index = hashSite(address, scope, source);
+
+        TrackerLock lock;
+        for (glm::u32 probe = 0; probe < ALLOCATION_SITES_MAX; probe++)
+        {
+            AllocationSite& site = s_sites[(index + probe) & (ALLOCATION_SITES_MAX - 1)];
+            if (site.total_allocations == 0)
+            {
+                site.address = address;
+                site.scope = scope;
+                site.source = source;
+            }
+            else if (site.address != address || site.scope != scope || site.source != source)
+            {
+                continue;
+            }
+
+            site.frame_allocations++;
+            site.frame_bytes += size;
+            site.total_allocations++;
+            site.total_bytes += size;
+            return;
+        }
+
+        s_dropped_sites++;
+    }
+
+    void AllocationTracker::recordDeallocation(std::size_t size, glm::u32 count)
+    {
+        (void) size;
+
+        if (t_suspended)
+            return;
+
+        TrackerLock lock;
+        s_frame_deallocations += count;
+    }
+
+    const char* AllocationTracker::getScope()
+    {
+        return t_scope;
+    }
+
+    void AllocationTracker::setScope(const char* scope)
+    {
+        t_scope = scope;
+    }
+
+    void AllocationTracker::setZeroAllocationMode(bool enabled)
+    {
+        TrackerLock lock;
+        s_zero_allocation_mode = enabled;
+    }
+
+    bool AllocationTracker::isZeroAllocationMode()
+    {
+        return s_zero_allocation_mode;
+    }
+
+    glm::u32 AllocationTracker::getZeroAllocationViolations()
+    {
+        return s_violations;
+    }
+
+    void AllocationTracker::endFrame()
+    {
+        static const glm::u32 REPORT_MAX = 16;
+
+        TrackerSuspend suspend;
+
+        AllocationSite offenders[REPORT_MAX];
+        glm::u32 offender_count = 0;
+        glm::u32 violations = 0;
+        {
+            TrackerLock lock;
+            for (AllocationSite& site : s_sites)
+            {
+                if (s_zero_allocation_mode && site.frame_allocations > 0 && !isFrameSafe(site.source))
+                {
+                    violations += site.frame_allocations;
+                    if (offender_count < REPORT_MAX)
+                    {
+                        offenders[offender_count] = site;
+                        offenders[offender_count].last_frame_allocations = site.frame_allocations;
+                        offenders[offender_count].last_frame_bytes = site.frame_bytes;
+                        offender_count++;
+                    }
+                }
+
+                site.last_frame_allocations = site.frame_allocations;
+                site.last_frame_bytes = site.frame_bytes;
+                site.frame_allocations = 0;
+                site.frame_bytes = 0;
+            }
+
+            s_last_frame_deallocations = s_frame_deallocations;
+            s_frame_deallocations = 0;
+            s_violations += violations;
+        }
+
+        if (violations)
+        {
+            Log::errorf("Zero allocation mode: %u allocations this frame", violations);
+            for (glm::u32 i = 0; i < offender_count; i++)
+                logSite(offenders[i]);
+        }
+    }
+
+    void AllocationTracker::dump()
+    {
+        TrackerSuspend suspend;
+
+        std::vector<AllocationSite> sites;
+        glm::u64 deallocations = 0;
+        glm::u32 dropped = 0;
+        {
+            TrackerLock lock;
+            for (const AllocationSite& site : s_sites)
+            {
+                if (site.total_allocations)
+                    sites.push_back(site);
+            }
+
+            deallocations = s_last_frame_deallocations;
+            dropped = s_dropped_sites;
+        }
+
+        std::sort(sites.begin(), sites.end(), [](const AllocationSite& lhs, const AllocationSite& rhs)
+        {
+            if (lhs.last_frame_allocations != rhs.last_frame_allocations)
+                return lhs.last_frame_allocations > rhs.last_frame_allocations;
+            return lhs.total_allocations > rhs.total_allocations;
+        });
+
+        glm::u64 frame_allocations = 0;
+        for (const AllocationSite& site : sites)
+            frame_allocations += site.last_frame_allocations;
+
+        Log::rawf("Allocation sites: %u, last frame %llu allocations %llu deallocations", (glm::u32) sites.size(), frame_allocations, deallocations);
+        for (const AllocationSite& site : sites)
+            logSite(site);
+
+        if (dropped)
+            Log::warnf("Allocation site table full, %u allocations were not attributed", dropped);
+    }
+
+    bool AllocationTracker::isEnabled()
+    {
+#ifdef ERIS_ALLOCATION_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+#ifdef ERIS_ALLOCATION_TRACKING
+void* operator new (std::size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    Eris::AllocationTracker::recordAllocation(_ReturnAddress(), Eris::ALLOCATION_SOURCE_GLOBAL, size);
+    return ptr;
+}
+
+void* operator new[] (std::size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    Eris::AllocationTracker::recordAllocation(_ReturnAddress(), Eris::ALLOCATION_SOURCE_GLOBAL, size);
+    return ptr;
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr)
+        Eris::AllocationTracker::recordAllocation(_ReturnAddress(), Eris::ALLOCATION_SOURCE_GLOBAL, size);
+    return ptr;
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr)
+        Eris::AllocationTracker::recordAllocation(_ReturnAddress(), Eris::ALLOCATION_SOURCE_GLOBAL, size);
+    return ptr;
+}
+
+void operator delete (void* ptr)
+{
+    if (ptr)
+    {
+        Eris::AllocationTracker::recordDeallocation(_msize(ptr));
+        free(ptr);
+    }
+}
+
+void operator delete[] (void* ptr)
+{
+    if (ptr)
+    {
+        Eris::AllocationTracker::recordDeallocation(_msize(ptr));
+        free(ptr);
+    }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <intrin.h>
+
+#pragma intrinsic(_ReturnAddress)
+
+namespace Eris
+{
+    static const glm::u8 ALLOCATION_SOURCE_GLOBAL = 0xFF;
+    static const glm::u32 ALLOCATION_SITES_MAX = 4096;
+
+    /// Allocations are aggregated by caller address, the innermost allocation scope and the pool type they came from.
+    struct AllocationSite
+    {
+        const void* address;
+        const char* scope;
+        glm::u8 source;
+        glm::u32 frame_allocations;
+        glm::u64 frame_bytes;
+        glm::u32 last_frame_allocations;
+        glm::u64 last_frame_bytes;
+        glm::u64 total_allocations;
+        glm::u64 total_bytes;
+    };
+
+    /// Compiled in with ERIS_ALLOCATION_TRACKING, which also replaces the global operator new and delete.
+    class AllocationTracker
+    {
+    public:
+        static void recordAllocation(const void* address, glm::u8 source, std::size_t size);
+        static void recordDeallocation(std::size_t size, glm::u32 count = 1);
+
+        static const char* getScope();
+        static void setScope(const char* scope);
+
+        /// While enabled any heap allocation in a frame is a violation, frame and stack pool allocations are allowed.
+        static void setZeroAllocationMode(bool enabled);
+        static bool isZeroAllocationMode();
+        static glm::u32 getZeroAllocationViolations();
+
+        static void endFrame();
+
+        /// Log every site that allocated during the last frame along with its lifetime totals.
+        static void dump();
+
+        static bool isEnabled();
+    };
+
+    class AllocationScope
+    {
+    public:
+        AllocationScope(const char* name) :
+            m_previous(AllocationTracker::getScope())
+        {
+            AllocationTracker::setScope(name);
+        }
+
+        ~AllocationScope()
+        {
+            AllocationTracker::setScope(m_previous);
+        }
+
+    private:
+        const char* m_previous;
+    };
+}
+
+#ifdef ERIS_ALLOCATION_TRACKING
+#define ERIS_TRACK_ALLOCATION(source, size) Eris::AllocationTracker::recordAllocation(_ReturnAddress(), (glm::u8) (source), (size))
+#define ERIS_TRACK_DEALLOCATION(size, count) Eris::AllocationTracker::recordDeallocation((size), (count))
+#else
+#define ERIS_TRACK_ALLOCATION(source, size)
+#define ERIS_TRACK_DEALLOCATION(size, count)
+#endif
\ No newline at end of file
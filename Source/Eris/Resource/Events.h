@@ -26,6 +26,15 @@
 
 namespace Eris
 {
+    struct ResourceLoaded : public Event
+    {
+        EVENT(ResourceLoaded)
+
+    public:
+        Path resource;
+        const char* type;
+    };
+
     struct ResourceLoadingFailed : public Event
     {
         EVENT(ResourceLoadingFailed)
@@ -24,7 +24,7 @@
 
 #include "Core/Log.h"
 #include "Core/Profiler.h"
-#include "Memory/ArrayPointers.h"
+#include "Memory/Scratch.h"
 
 #include <cstring>
 #include <sstream>
@@ -42,18 +42,24 @@ namespace Eris
 
         std::size_t ds_size = deserializer.getSize();
 
-        SharedArrayPtr<char> buffer = SharedArrayPtr<char>(ds_size + 1);
-        std::size_t in_size = deserializer.read(buffer.get(), ds_size);
+        ScratchScope scratch;
+        char* buffer = scratch.allocateArray<char>(ds_size + 1);
+        if (!buffer)
+            return false;
+
+        std::size_t in_size = deserializer.read(buffer, ds_size);
 
         if (in_size != ds_size)
             return false;
+
+        buffer[ds_size] = '\0';
         
         char* line = nullptr;
         char* next_line = nullptr;
         char* section = nullptr;
         char* next_section = nullptr;
             
-        line = strtok_s(buffer.get(), "\r\n\0", &next_line);
+        line = strtok_s(buffer, "\r\n\0", &next_line);
         while (line)
         {
             if (line[0] == '[')
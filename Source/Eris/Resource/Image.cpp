@@ -24,6 +24,12 @@
 
 #include "Core/Log.h"
 #include "Core/Profiler.h"
+#include "Memory/Memory.h"
+#include "Memory/Scratch.h"
+
+#define STBI_MALLOC(size) Eris::TlsfMemoryPool::getDefault()->allocate(size, 16)
+#define STBI_REALLOC(ptr, size) Eris::TlsfMemoryPool::getDefault()->reallocate(ptr, size)
+#define STBI_FREE(ptr) Eris::TlsfMemoryPool::getDefault()->deallocate(ptr)
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
@@ -44,18 +50,28 @@ namespace Eris
     {
     }
 
+    Image::~Image()
+    {
+        TlsfMemoryPool::getDefault()->deallocate(m_data);
+    }
+
     bool Image::load(Deserializer& deserializer)
     {
         PROFILE(LoadImage);
 
         std::size_t ds_size = deserializer.getSize();
 
-        SharedArrayPtr<unsigned char> buffer(ds_size);
-        std::size_t read_size = deserializer.read(buffer.get(), ds_size);
+        ScratchScope scratch;
+        unsigned char* buffer = scratch.allocateArray<unsigned char>(ds_size);
+        if (!buffer)
+            return false;
+
+        std::size_t read_size = deserializer.read(buffer, ds_size);
 
-        if (!buffer || read_size != ds_size)
+        if (read_size != ds_size)
             return false;
 
+        TlsfMemoryPool::getDefault()->deallocate(m_data);
         m_data = stbi_load_from_memory(buffer, ds_size, &m_width, &m_height, &m_components, 0);
 
         if (!m_data || m_width <= 0 || m_height <= 0 || m_components <= 0)
@@ -88,14 +104,21 @@ namespace Eris
         if (width == 0 || height == 0)
             return false;
 
-        SharedArrayPtr<unsigned char> new_buffer(width * height * m_components);
+        TlsfMemoryPool* pool = TlsfMemoryPool::getDefault();
+        unsigned char* new_buffer = reinterpret_cast<unsigned char*>(pool->allocate(width * height * m_components, 16));
+        if (!new_buffer)
+            return false;
+
         glm::i32 new_width = 0, new_height = 0;
-        if (stbir_resize_uint8(m_data.get(), m_width, m_height, 0, new_buffer.get(), new_width, new_height, 0, m_components) == 0)
+        if (stbir_resize_uint8(m_data, m_width, m_height, 0, new_buffer, new_width, new_height, 0, m_components) == 0)
         {
             Log::errorf("Failed to resize image: %s to width: %d height: %d", getName(), width, height);
+            pool->deallocate(new_buffer);
             return false;
         }
 
+        pool->deallocate(m_data);
+
         m_width = new_width;
         m_height = new_height;
         m_data = new_buffer;
@@ -106,17 +129,21 @@ namespace Eris
     void Image::flip()
     {
         glm::u64 row_size = m_components * m_width;
-        SharedArrayPtr<unsigned char> row_buffer(row_size);
+        ScratchScope scratch;
+        unsigned char* row_buffer = scratch.allocateArray<unsigned char>(row_size);
+        if (!row_buffer)
+            return;
+
         glm::u32 half_rows = m_height / 2;
 
         for (glm::u32 i = 0; i < half_rows; i++)
         {
-            unsigned char* row = m_data.get() + getPixelOffset(0, i, m_width, m_height, m_components);
-            unsigned char* oppositeRow = m_data.get() + getPixelOffset(0, m_height - i - 1, m_width, m_height, m_components);
+            unsigned char* row = m_data + getPixelOffset(0, i, m_width, m_height, m_components);
+            unsigned char* oppositeRow = m_data + getPixelOffset(0, m_height - i - 1, m_width, m_height, m_components);
 
-            memcpy(row_buffer.get(), row, row_size);
+            memcpy(row_buffer, row, row_size);
             memcpy(row, oppositeRow, row_size);
-            memcpy(oppositeRow, row_buffer.get(), row_size);
+            memcpy(oppositeRow, row_buffer, row_size);
         }
     }
 
@@ -145,7 +172,16 @@ namespace Eris
     {
         ERIS_ASSERT(data);
         if (data)
-            m_data = data;
+        {
+            // Pixels are copied into the image's own buffer, so width, height and components must already be set.
+            TlsfMemoryPool* pool = TlsfMemoryPool::getDefault();
+            std::size_t size = m_width * m_height * m_components;
+
+            pool->deallocate(m_data);
+            m_data = reinterpret_cast<unsigned char*>(pool->allocate(size, 16));
+            if (m_data)
+                memcpy(m_data, data, size);
+        }
     }
 
     glm::u32 Image::getPixelOffset(glm::u32 column, glm::u32 row, glm::i32 width, glm::i32 height, glm::i32 channels)
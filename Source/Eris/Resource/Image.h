@@ -32,6 +32,7 @@ namespace Eris
     {
     public:
         Image(Context* context);
+        virtual ~Image();
 
         virtual bool load(Deserializer& deserializer) override;
         virtual bool save(Serializer& serializer) override;
@@ -55,6 +56,6 @@ namespace Eris
         glm::i32 m_width;
         glm::i32 m_height;
         glm::i32 m_components;
-        SharedArrayPtr<unsigned char> m_data;
+        unsigned char* m_data;
     };
 }
@@ -492,11 +492,11 @@ namespace Eris
 
     StringHash JsonElement::getHash(StringHash default) const
     {
-        StringHash value(m_value->GetString());
-        if (value == StringEmpty)
+        const char* value = m_value->GetString();
+        if (!*value)
             return default;
 
-        return value;
+        return STRING_HASH(value);
     }
 
     bool JsonElement::setValue(const std::string& value)
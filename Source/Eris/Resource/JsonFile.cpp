@@ -25,7 +25,8 @@
 #include "Core/Log.h"
 #include "Core/Profiler.h"
 #include "Collections/Functions.h"
-#include "Memory/ArrayPointers.h"
+#include "Memory/Memory.h"
+#include "Memory/Scratch.h"
 
 #include <boost/lexical_cast.hpp>
 
@@ -68,8 +69,11 @@ namespace Eris
 
     JsonFile::JsonFile(Context* context) :
         Resource(context),
-        m_doc(new rapidjson::Document())
+        m_doc(nullptr),
+        m_allocator(nullptr),
+        m_buffer(nullptr)
     {
+        createDocument(0);
     }
 
     JsonFile::~JsonFile()
@@ -79,6 +83,14 @@ namespace Eris
             delete m_doc;
             m_doc = nullptr;
         }
+
+        if (m_allocator)
+        {
+            delete m_allocator;
+            m_allocator = nullptr;
+        }
+
+        TlsfMemoryPool::getDefault()->deallocate(m_buffer);
     }
 
     bool JsonFile::load(Deserializer& deserializer)
@@ -86,13 +98,21 @@ namespace Eris
         PROFILE(LoadJsonFile);
 
         std::size_t ds_size = deserializer.getSize();
-        SharedArrayPtr<char> buffer(ds_size);
+
+        ScratchScope scratch;
+        char* buffer = scratch.allocateArray<char>(ds_size + 1);
+        if (!buffer)
+            return false;
+
         std::size_t read = deserializer.read(buffer, ds_size);
         if (read != ds_size)
         {
             return false;
         }
 
+        buffer[ds_size] = '\0';
+
+        createDocument(ds_size * JSON_DOCUMENT_SCALE);
         m_doc->Parse<rapidjson::kParseStopWhenDoneFlag>(buffer);
 
         if (m_doc->HasParseError())
@@ -105,6 +125,25 @@ namespace Eris
         return true;
     }
 
+    void JsonFile::createDocument(std::size_t capacity)
+    {
+        TlsfMemoryPool* pool = TlsfMemoryPool::getDefault();
+
+        delete m_doc;
+        delete m_allocator;
+        pool->deallocate(m_buffer);
+
+        // The document's first chunk comes from the TLSF pool sized from the file, so a
+        // typical load never falls back to the CRT heap.
+        m_buffer = capacity ? pool->allocate(capacity, 16) : nullptr;
+        if (m_buffer)
+            m_allocator = new rapidjson::MemoryPoolAllocator<>(m_buffer, capacity);
+        else
+            m_allocator = new rapidjson::MemoryPoolAllocator<>();
+
+        m_doc = new rapidjson::Document(m_allocator);
+    }
+
     bool JsonFile::save(Serializer& serializer)
     {
         PROFILE(SaveJsonFile);
@@ -27,6 +27,8 @@
 
 namespace Eris
 {
+    static const std::size_t JSON_DOCUMENT_SCALE = 2;
+
     struct JsonPath
     {
         rapidjson::Value* operator()();
@@ -55,10 +57,14 @@ namespace Eris
         rapidjson::Document* getDocument() const { return m_doc; }
 
     private:
+        void createDocument(std::size_t capacity);
+
         void patchAdd(rapidjson::Value* patch, const rapidjson::Value& path);
         void patchReplace(rapidjson::Value* patch, const rapidjson::Value& path);
         void patchRemove(rapidjson::Value* patch, const rapidjson::Value& path);
 
         rapidjson::Document* m_doc;
+        rapidjson::MemoryPoolAllocator<>* m_allocator;
+        void* m_buffer;
     };
 }
@@ -22,11 +22,16 @@
 
 #include "ResourceLoader.h"
 
+#include "Events.h"
+
 #include "IO/File.h"
 #include "Core/Log.h"
+#include "Core/Profiler.h"
 
 namespace Eris
 {
+    static ProfilerCounter s_resources_loaded("ResourcesLoaded");
+
     ResourceLoader::ResourceLoader(Context* context) : 
         Object(context),
         m_thread_exit(false)
@@ -48,56 +53,56 @@ namespace Eris
 
         res->setAsyncState(AsyncState::QUEUED);
 
-        std::lock_guard<std::mutex> lock(m_queue_mutex);
         m_waiting_tasks.push(new ResourceTask(path, res));
-
-        m_queue_conditional.notify_all();
+        m_waiting_count.signal();
     }
 
     void ResourceLoader::stop()
     {
         m_thread_exit = true;
-        m_queue_conditional.notify_all();
+        m_waiting_count.signal();
 
         if (m_thread.joinable())
             m_thread.join();
+
+        while (ResourceTask* task = m_waiting_tasks.pop())
+            delete task;
     }
 
     void ResourceLoader::run()
     {
         Log::infof("Resource Thread started: %d", std::this_thread::get_id().hash());
-        while (!m_thread_exit)
+        Profiler::setThreadName("ResourceLoader");
+        for (;;)
         {
+            m_waiting_count.wait();
+            if (m_thread_exit)
+                break;
+
             ResourceTask* task = poll();
             if (task)
                 load(task);
-            else
-            {
-                std::unique_lock<std::mutex> lock(m_queue_mutex);
-                m_queue_conditional.wait(lock);
-            }
         }
         Log::infof("Resource Thread stopped: %d", std::this_thread::get_id().hash());
     }
 
     ResourceTask* ResourceLoader::poll()
     {
-        std::lock_guard<std::mutex> lock(m_queue_mutex);
-        while (m_waiting_tasks.size() > 0)
+        // The permit guarantees a task, it can only be missing while its producer finishes linking it.
+        ResourceTask* task = m_waiting_tasks.pop();
+        while (!task)
         {
-            ResourceTask* task = m_waiting_tasks.front();
-            m_waiting_tasks.pop();
-
-            if (task->m_resource->getAsyncState() != AsyncState::QUEUED)
-            {
-                delete task;
-                continue;
-            }
+            std::this_thread::yield();
+            task = m_waiting_tasks.pop();
+        }
 
-            return task;
+        if (task->m_resource->getAsyncState() != AsyncState::QUEUED)
+        {
+            delete task;
+            return nullptr;
         }
 
-        return nullptr;
+        return task;
     }
 
     void ResourceLoader::load(ResourceTask* task)
@@ -107,23 +112,26 @@ namespace Eris
             task->m_resource->setAsyncState(AsyncState::LOADING);
 
             SharedPtr<File> file(new File(m_context, task->m_path));
-            if (file && file->isOpened())
+            if (file && file->isOpened() && task->m_resource->load(*file))
             {
-                if (task->m_resource->load(*file))
-                {
-                    task->m_resource->setAsyncState(AsyncState::SUCCESS);
-                    Log::infof("Successful loading %s: %s", &typeid(*task->m_resource).name()[12], task->m_resource->getName());
-                }
-                else
-                {
-                    task->m_resource->setAsyncState(AsyncState::FAILED);
-                    Log::errorf("Failed loading %s: %s", &typeid(*task->m_resource).name()[12], task->m_resource->getName());
-                }
+                task->m_resource->setAsyncState(AsyncState::SUCCESS);
+                s_resources_loaded.add();
+                Log::infof("Successful loading %s: %s", &typeid(*task->m_resource).name()[12], task->m_resource->getName());
+
+                ResourceLoaded* event = m_context->getFrameAllocator().newInstance<ResourceLoaded>();
+                event->resource = task->m_path;
+                event->type = typeid(*task->m_resource).name();
+                postEvent(ResourceLoaded::getTypeStatic(), event);
             }
             else
             {
                 task->m_resource->setAsyncState(AsyncState::FAILED);
                 Log::errorf("Failed loading %s: %s", &typeid(*task->m_resource).name()[12], task->m_resource->getName());
+
+                ResourceLoadingFailed* event = m_context->getFrameAllocator().newInstance<ResourceLoadingFailed>();
+                event->resource = task->m_path;
+                event->type = typeid(*task->m_resource).name();
+                postEvent(ResourceLoadingFailed::getTypeStatic(), event);
             }
         }
         
@@ -26,13 +26,18 @@
 
 #include "Core/Context.h"
 #include "Core/Object.h"
+#include "Memory/Memory.h"
 #include "Memory/Pointers.h"
+#include "Thread/MpscQueue.h"
+#include "Thread/Semaphore.h"
 #include "Util/NonCopyable.h"
 
 namespace Eris
 {
-    struct ResourceTask
+    struct ResourceTask : public MpscNode
     {
+        SLAB_ALLOCATED
+
         ResourceTask(const Path& path, Resource* res) :
             m_path(path),
             m_resource(res)
@@ -57,10 +62,10 @@ namespace Eris
         ResourceTask* poll();
         void load(ResourceTask* task);
 
-        std::queue<ResourceTask*> m_waiting_tasks;
-        std::mutex m_queue_mutex;
+        MpscQueue<ResourceTask> m_waiting_tasks;
+        /// One permit per queued task, plus one to wake the thread when stopping.
+        Semaphore m_waiting_count;
         std::thread m_thread;
-        std::condition_variable m_queue_conditional;
         std::atomic<bool> m_thread_exit;
     };
 }
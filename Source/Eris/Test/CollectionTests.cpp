@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tests.h"
+
+#include "Collections/StringHash.h"
+#include "Core/Log.h"
+
+#include <random>
+#include <string>
+
+namespace Eris
+{
+    static const glm::u32 TEST_HASH_STRINGS = 10000;
+    static const std::size_t TEST_HASH_LONG_STRING = 16 * 1024 * 1024;
+
+    bool testStringHash(Context* context)
+    {
+        // Reference FNV-1a values, through the literal and both runtime paths
+        const char* foobar = "foobar";
+        bool passed = StringHash("").getValue() == 0x811c9dc5 && StringHash("a").getValue() == 0xe40c292c &&
+            StringHash("foobar").getValue() == 0xbf9cf968 && StringHash(foobar).getValue() == 0xbf9cf968 &&
+            StringHash(std::string("foobar")).getValue() == 0xbf9cf968;
+
+        StringHash assigned;
+        assigned = foobar;
+        passed = passed && assigned == StringHash("foobar");
+        assigned = std::string("UpdateEvent");
+        passed = passed && assigned == StringHash("UpdateEvent");
+
+        // The recursive literal hash and the runtime loop must agree on every string
+        std::mt19937 random(1);
+        std::string value;
+        for (glm::u32 i = 0; i < TEST_HASH_STRINGS && passed; ++i)
+        {
+            value.resize(random() % 256);
+            for (char& c : value)
+                c = static_cast<char>(1 + random() % 255);
+
+            passed = calculateStringHash(value.c_str()) == calculateRuntimeStringHash(value) &&
+                calculateRuntimeStringHash(value) == StringHash(value).getValue();
+        }
+
+        // Far deeper than any stack would let the recursive form go
+        std::string long_value(TEST_HASH_LONG_STRING, 'x');
+        glm::f64 begin = getTestTime();
+        StringHash long_hash(long_value);
+        glm::f64 elapsed = getTestTime() - begin;
+        passed = passed && long_hash.getValue() == calculateRuntimeStringHash(long_value.c_str());
+
+        Log::rawf("\tRuntime hash %.2f ns/char over %llu chars", elapsed * 1e9 / TEST_HASH_LONG_STRING, (glm::u64) TEST_HASH_LONG_STRING);
+
+        return passed;
+    }
+}
\ No newline at end of file
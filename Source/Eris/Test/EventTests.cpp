@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tests.h"
+
+#include "Core/Context.h"
+#include "Core/Log.h"
+#include "Core/Object.h"
+#include "Engine/Events.h"
+#include "Memory/Pointers.h"
+
+#include <vector>
+
+namespace Eris
+{
+    static const glm::u32 TEST_SUBSCRIBERS = 10000;
+    static const glm::u32 TEST_SPECIFIC_SUBSCRIBERS = 100;
+    static const glm::u32 TEST_SENDS = 200;
+
+    class TestSubscriber : public Object
+    {
+    public:
+        TestSubscriber(Context* context) :
+            Object(context)
+        {
+        }
+
+        void handleUpdate(const UpdateEvent& event)
+        {
+            m_updates++;
+        }
+
+        void handleSpecificUpdate(const UpdateEvent& event)
+        {
+            m_specific_updates++;
+        }
+
+        glm::u32 m_updates = 0;
+        glm::u32 m_specific_updates = 0;
+    };
+
+    /// Subscribes a newcomer and unsubscribes a victim from inside its handler, on the first update only.
+    class TestMutatingSubscriber : public Object
+    {
+    public:
+        TestMutatingSubscriber(Context* context, TestSubscriber* victim, TestSubscriber* newcomer) :
+            Object(context),
+            m_victim(victim),
+            m_newcomer(newcomer)
+        {
+        }
+
+        void handleUpdate(const UpdateEvent& event)
+        {
+            if (m_updates++)
+                return;
+
+            m_victim->unsubscribe<UpdateEvent>();
+            m_newcomer->subscribe<UpdateEvent, TestSubscriber, &TestSubscriber::handleUpdate>(m_newcomer);
+        }
+
+        glm::u32 m_updates = 0;
+
+    private:
+        TestSubscriber* m_victim;
+        TestSubscriber* m_newcomer;
+    };
+
+    bool testEventDispatch(Context* context)
+    {
+        SharedPtr<Object> sender(new Object(context));
+        SharedPtr<TestSubscriber> victim(new TestSubscriber(context));
+        SharedPtr<TestSubscriber> newcomer(new TestSubscriber(context));
+        SharedPtr<TestMutatingSubscriber> mutator(new TestMutatingSubscriber(context, victim, newcomer));
+
+        // The mutator is dispatched first and the victim last, so the victim is removed before its turn comes.
+        mutator->subscribe<UpdateEvent, TestMutatingSubscriber, &TestMutatingSubscriber::handleUpdate>(mutator);
+
+        std::vector<SharedPtr<TestSubscriber>> subscribers;
+        subscribers.reserve(TEST_SUBSCRIBERS);
+        for (glm::u32 i = 0; i < TEST_SUBSCRIBERS; ++i)
+        {
+            SharedPtr<TestSubscriber> subscriber(new TestSubscriber(context));
+            subscriber->subscribe<UpdateEvent, TestSubscriber, &TestSubscriber::handleUpdate>(subscriber);
+            // A few also listen to this sender in particular, which takes precedence over their generic handler.
+            if (i < TEST_SPECIFIC_SUBSCRIBERS)
+                subscriber->subscribe<UpdateEvent, TestSubscriber, &TestSubscriber::handleSpecificUpdate>(subscriber, sender);
+            subscribers.push_back(subscriber);
+        }
+        victim->subscribe<UpdateEvent, TestSubscriber, &TestSubscriber::handleUpdate>(victim);
+
+        UpdateEvent event;
+        event.time_step = 0.0;
+
+        // Subscribed during the first dispatch, so only picked up from the second one on
+        sender->sendEvent(UpdateEvent::getTypeStatic(), &event);
+        bool passed = victim->m_updates == 0 && newcomer->m_updates == 0;
+
+        std::vector<glm::f64> latencies;
+        latencies.reserve(TEST_SENDS);
+        for (glm::u32 i = 1; i < TEST_SENDS; ++i)
+        {
+            glm::f64 begin = getTestTime();
+            sender->sendEvent(UpdateEvent::getTypeStatic(), &event);
+            latencies.push_back(getTestTime() - begin);
+        }
+
+        passed = passed && mutator->m_updates == TEST_SENDS && victim->m_updates == 0 && newcomer->m_updates == TEST_SENDS - 1;
+        for (glm::u32 i = 0; i < TEST_SUBSCRIBERS; ++i)
+        {
+            const TestSubscriber* subscriber = subscribers[i];
+            if (i < TEST_SPECIFIC_SUBSCRIBERS)
+                passed = passed && subscriber->m_updates == 0 && subscriber->m_specific_updates == TEST_SENDS;
+            else
+                passed = passed && subscriber->m_updates == TEST_SENDS && subscriber->m_specific_updates == 0;
+        }
+
+        logPercentiles("UpdateEvent to 10k subscribers", latencies);
+        Log::rawf("\t%.1f ns per subscriber at the median", latencies[latencies.size() / 2] * 1e9 / TEST_SUBSCRIBERS);
+
+        // Tearing the subscribers down must leave nothing behind in the dispatcher
+        subscribers.clear();
+        mutator.reset();
+        sender->sendEvent(UpdateEvent::getTypeStatic(), &event);
+
+        passed = passed && newcomer->m_updates == TEST_SENDS;
+
+        // Replacing a subscription is explicit, the old handler of a sender is found through that sender's recievers
+        SharedPtr<TestSubscriber> replaced(new TestSubscriber(context));
+        replaced->subscribe<UpdateEvent, TestSubscriber, &TestSubscriber::handleUpdate>(replaced, sender);
+        replaced->resubscribeToEvent(UpdateEvent::getTypeStatic(),
+            new TypedEventHandler<TestSubscriber, UpdateEvent, &TestSubscriber::handleSpecificUpdate>(replaced), sender);
+        sender->sendEvent(UpdateEvent::getTypeStatic(), &event);
+        passed = passed && replaced->m_updates == 0 && replaced->m_specific_updates == 1;
+
+        replaced->unsubscribe<UpdateEvent>(sender);
+        sender->sendEvent(UpdateEvent::getTypeStatic(), &event);
+
+        return passed && replaced->m_specific_updates == 1 && newcomer->m_updates == TEST_SENDS + 2;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,421 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tests.h"
+
+#include "Core/Log.h"
+#include "Memory/Allocator.h"
+#include "Memory/Memory.h"
+#include "Memory/Pointers.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+namespace Eris
+{
+    static const glm::u32 TEST_THREADS = 8;
+    static const glm::u32 TEST_ROUNDS = 2000;
+    static const glm::u32 TEST_BATCH = 64;
+
+    static const glm::u32 TEST_POINTER_COPIES = 4000000;
+
+    static const glm::u32 TEST_SET_KEYS = 512;
+    static const glm::u32 TEST_SET_ROUNDS = 2000;
+
+    class TestBase
+    {
+    public:
+        virtual ~TestBase() {}
+
+        glm::u32 m_base = 0;
+    };
+
+    /// RefCounted deliberately not the first base, so the object and its counts start at different addresses.
+    class TestCounted : public TestBase, public RefCounted
+    {
+    public:
+        TestCounted(RefCountPolicy policy = RefCountPolicy::ATOMIC) :
+            RefCounted(policy)
+        {
+            s_alive++;
+        }
+
+        virtual ~TestCounted()
+        {
+            s_alive--;
+        }
+
+        static std::atomic<glm::i32> s_alive;
+
+        glm::u8 m_payload[48];
+    };
+
+    std::atomic<glm::i32> TestCounted::s_alive(0);
+
+    static const glm::u32 TEST_LIVE_BLOCKS = 4096;
+    static const glm::u32 TEST_OPERATIONS = 200000;
+
+    /// Random sizes and lifetimes: mostly small, with the occasional vertex buffer or image.
+    static std::size_t getRandomSize(std::mt19937& random)
+    {
+        glm::u32 roll = random() % 100;
+        if (roll < 70)
+            return 16 + random() % 240;
+        else if (roll < 95)
+            return 256 + random() % 3840;
+        else
+            return 4096 + random() % 61440;
+    }
+
+    /// Replaces random live blocks for a while, timing every allocate.
+    template<typename Pool>
+    static bool churnPool(Pool* pool, std::vector<glm::f64>& latencies, std::size_t& peak_live)
+    {
+        std::mt19937 random(7);
+        std::vector<std::pair<glm::u8*, std::size_t>> blocks(TEST_LIVE_BLOCKS);
+        std::size_t live = 0;
+        bool passed = true;
+
+        latencies.clear();
+        latencies.reserve(TEST_OPERATIONS);
+        peak_live = 0;
+
+        for (glm::u32 i = 0; i < TEST_OPERATIONS + TEST_LIVE_BLOCKS; ++i)
+        {
+            auto& block = blocks[random() % TEST_LIVE_BLOCKS];
+            if (block.first)
+            {
+                if (block.first[0] != static_cast<glm::u8>(block.second) || block.first[block.second - 1] != static_cast<glm::u8>(block.second))
+                    passed = false;
+
+                pool->deallocate(block.first);
+                live -= block.second;
+            }
+
+            block.second = getRandomSize(random);
+
+            glm::f64 begin = getTestTime();
+            block.first = static_cast<glm::u8*>(pool->allocate(block.second, 16));
+            if (i >= TEST_LIVE_BLOCKS)
+                latencies.push_back(getTestTime() - begin);
+
+            block.first[0] = block.first[block.second - 1] = static_cast<glm::u8>(block.second);
+            live += block.second;
+            peak_live = glm::max(peak_live, live);
+        }
+
+        for (auto& block : blocks)
+        {
+            if (block.first)
+                pool->deallocate(block.first);
+        }
+
+        return passed;
+    }
+
+    template<typename Pointer>
+    static glm::f64 benchmarkCopies(const Pointer& source)
+    {
+        glm::f64 begin = getTestTime();
+
+        for (glm::u32 i = 0; i < TEST_POINTER_COPIES; ++i)
+        {
+            Pointer copy(source);
+            Pointer second(copy);
+        }
+
+        return TEST_POINTER_COPIES * 2 / (getTestTime() - begin) / 1e6;
+    }
+
+    template<typename Pool>
+    static glm::f64 benchmarkPool(Pool* pool, glm::u32 thread_count)
+    {
+        std::vector<std::thread> threads;
+        std::atomic<bool> start(false);
+
+        for (glm::u32 t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([pool, &start]
+            {
+                void* blocks[TEST_BATCH];
+
+                while (!start.load())
+                    std::this_thread::yield();
+
+                for (glm::u32 round = 0; round < TEST_ROUNDS; ++round)
+                {
+                    for (glm::u32 i = 0; i < TEST_BATCH; ++i)
+                        blocks[i] = pool->allocate(16 + (i & 7) * 24, 16);
+                    for (glm::u32 i = 0; i < TEST_BATCH; ++i)
+                        pool->deallocate(blocks[i]);
+                }
+            });
+        }
+
+        glm::f64 begin = getTestTime();
+        start = true;
+        for (auto& thread : threads)
+            thread.join();
+
+        return thread_count * TEST_ROUNDS * TEST_BATCH / (getTestTime() - begin) / 1e6;
+    }
+
+    bool testChainMemoryPool(Context* context)
+    {
+        bool passed = true;
+
+        {
+            SharedPtr<ChainMemoryPool> pool(new ChainMemoryPool(4096, 64 * 1024));
+            std::mutex handoff_lock;
+            std::vector<glm::u8*> handoff;
+            std::atomic<bool> corrupted(false);
+            std::vector<std::thread> threads;
+
+            for (glm::u32 t = 0; t < TEST_THREADS; ++t)
+            {
+                threads.emplace_back([&, t]
+                {
+                    std::mt19937 random(t);
+                    std::vector<glm::u8*> blocks;
+
+                    for (glm::u32 round = 0; round < TEST_ROUNDS; ++round)
+                    {
+                        for (glm::u32 i = 0; i < TEST_BATCH; ++i)
+                        {
+                            std::size_t size = 1 + random() % 256;
+                            glm::u8* block = static_cast<glm::u8*>(pool->allocate(size, 16));
+                            block[0] = block[size - 1] = static_cast<glm::u8>(t);
+                            blocks.push_back(block);
+                        }
+
+                        // Every other batch is freed by whichever thread picks it up
+                        std::lock_guard<std::mutex> lock(handoff_lock);
+                        for (glm::u8* block : handoff)
+                            pool->deallocate(block);
+                        handoff.clear();
+
+                        for (glm::u8* block : blocks)
+                        {
+                            if (block[0] != static_cast<glm::u8>(t))
+                                corrupted = true;
+                        }
+
+                        if (round & 1)
+                            handoff.swap(blocks);
+                        else
+                        {
+                            for (glm::u8* block : blocks)
+                                pool->deallocate(block);
+                        }
+                        blocks.clear();
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (glm::u8* block : handoff)
+                pool->deallocate(block);
+
+            // The tails of the exited threads must have been given up
+            Log::rawf("\tChains left after exit: %llu chunks, %llu bytes", (glm::u64) pool->getChunksCount(), (glm::u64) pool->getAllocatedSize());
+            passed = !corrupted.load() && pool->getChunksCount() == 0 && pool->getAllocatedSize() == 0;
+        }
+
+        for (glm::u32 thread_count = 1; thread_count <= TEST_THREADS; thread_count *= 2)
+        {
+            SharedPtr<ChainMemoryPool> chain(new ChainMemoryPool(4096, 64 * 1024));
+            SharedPtr<HeapMemoryPool> heap(new HeapMemoryPool());
+
+            glm::f64 chain_rate = benchmarkPool(chain.get(), thread_count);
+            glm::f64 heap_rate = benchmarkPool(heap.get(), thread_count);
+
+            Log::rawf("\t%u threads: chain %.2f Mops/s, heap %.2f Mops/s", thread_count, chain_rate, heap_rate);
+        }
+
+        return passed;
+    }
+
+    bool testSharedPtr(Context* context)
+    {
+        bool passed = true;
+
+        {
+            // Plain delete and the last strong release both leave the counts to the weak references
+            TestCounted* deleted = new TestCounted();
+            WeakPtr<TestCounted> deleted_weak(deleted);
+            delete deleted;
+
+            SharedPtr<TestCounted> released(new TestCounted(RefCountPolicy::LOCAL));
+            WeakPtr<TestCounted> released_weak(released);
+            released.reset();
+
+            TestCounted local;
+            WeakPtr<TestCounted> local_weak(&local);
+
+            passed = passed && deleted_weak.isExpired() && released_weak.isExpired() && !local_weak.isExpired();
+        }
+
+        {
+            SharedPtr<TestCounted> shared(new TestCounted());
+            std::vector<std::thread> threads;
+
+            for (glm::u32 t = 0; t < TEST_THREADS; ++t)
+            {
+                threads.emplace_back([&shared, t]
+                {
+                    std::mt19937 random(t);
+
+                    for (glm::u32 i = 0; i < TEST_ROUNDS * 10; ++i)
+                    {
+                        SharedPtr<TestCounted> copy(shared);
+                        WeakPtr<TestCounted> weak(copy);
+
+                        // Short lived objects handed between strong and weak references
+                        SharedPtr<TestCounted> temporary(new TestCounted());
+                        WeakPtr<TestCounted> temporary_weak(temporary);
+                        if (random() & 1)
+                            temporary.reset();
+                    }
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            passed = passed && shared.getRefs() == 1 && shared.getWeakRefs() == 0;
+        }
+
+        Log::rawf("	Objects left: %d", TestCounted::s_alive.load());
+        passed = passed && TestCounted::s_alive.load() == 0;
+
+        SharedPtr<TestCounted> atomic(new TestCounted());
+        SharedPtr<TestCounted> local(new TestCounted(RefCountPolicy::LOCAL));
+        std::shared_ptr<TestCounted> standard = std::make_shared<TestCounted>();
+
+        Log::rawf("	Copy and destroy: atomic %.1f M/s, local %.1f M/s, std::shared_ptr %.1f M/s",
+            benchmarkCopies(atomic), benchmarkCopies(local), benchmarkCopies(standard));
+
+        glm::f64 begin = getTestTime();
+        for (glm::u32 i = 0; i < TEST_POINTER_COPIES / 10; ++i)
+            SharedPtr<TestCounted> created(new TestCounted());
+        glm::f64 created_rate = TEST_POINTER_COPIES / 10 / (getTestTime() - begin) / 1e6;
+
+        begin = getTestTime();
+        for (glm::u32 i = 0; i < TEST_POINTER_COPIES / 10; ++i)
+            std::shared_ptr<TestCounted> created = std::make_shared<TestCounted>();
+        glm::f64 standard_rate = TEST_POINTER_COPIES / 10 / (getTestTime() - begin) / 1e6;
+
+        Log::rawf("	Create and destroy: SharedPtr %.1f M/s, std::make_shared %.1f M/s", created_rate, standard_rate);
+
+        return passed;
+    }
+
+    bool testTlsfMemoryPool(Context* context)
+    {
+        SharedPtr<TlsfMemoryPool> tlsf(new TlsfMemoryPool(TLSF_AREA_SIZE));
+        SharedPtr<HeapMemoryPool> heap(new HeapMemoryPool());
+        std::vector<glm::f64> latencies;
+        std::size_t peak_live = 0;
+
+        bool passed = churnPool(tlsf.get(), latencies, peak_live);
+
+        // Areas never shrink, so the reserve against the peak live bytes is the fragmentation left behind
+        std::size_t reserved = tlsf->getChunks() * TLSF_AREA_SIZE;
+        Log::rawf("	TLSF: %.1f MB reserved for %.1f MB peak live, %.0f%% overhead", reserved / 1048576.0, peak_live / 1048576.0,
+            (reserved / (glm::f64) peak_live - 1.0) * 100.0);
+        logPercentiles("TLSF allocate", latencies);
+
+        passed = churnPool(heap.get(), latencies, peak_live) && passed;
+        logPercentiles("Heap allocate", latencies);
+
+        // Oversized requests must fail cleanly instead of reaching the lists
+        glm::u32 failures = tlsf->getFailedAllocations();
+        passed = passed && !tlsf->allocate(~std::size_t(0) - 1024, 16) && tlsf->getFailedAllocations() == failures + 1;
+
+        return passed && tlsf->getUsedSize() == 0;
+    }
+
+    template<typename Set>
+    static glm::f64 benchmarkSet(Set& set, bool& passed)
+    {
+        glm::f64 begin = getTestTime();
+        for (glm::u32 round = 0; round < TEST_SET_ROUNDS; ++round)
+        {
+            for (glm::u32 key = 0; key < TEST_SET_KEYS; ++key)
+                set.insert(static_cast<int>(round + key));
+            passed = passed && set.size() == TEST_SET_KEYS;
+            for (glm::u32 key = 0; key < TEST_SET_KEYS; ++key)
+                set.erase(static_cast<int>(round + key));
+            passed = passed && set.empty();
+        }
+        return (getTestTime() - begin) * 1e9 / (TEST_SET_ROUNDS * TEST_SET_KEYS * 2);
+    }
+
+    bool testChainAllocator(Context* context)
+    {
+        bool passed = true;
+
+        SharedPtr<ChainMemoryPool> pool(new ChainMemoryPool(4096, 64 * 1024));
+        glm::f64 chain_time;
+        {
+            // Every node allocation copies or rebinds the allocator, which is now just the pool handle
+            std::unordered_set<int, std::hash<int>, std::equal_to<int>, ChainAllocator<int>> set(TEST_SET_KEYS, std::hash<int>(),
+                std::equal_to<int>(), ChainAllocator<int>(pool.get()));
+            chain_time = benchmarkSet(set, passed);
+        }
+
+        std::unordered_set<int> standard_set(TEST_SET_KEYS);
+        glm::f64 standard_time = benchmarkSet(standard_set, passed);
+
+        Log::rawf("\tunordered_set insert/erase: ChainAllocator %.1f ns/op, std::allocator %.1f ns/op, allocator size %llu bytes",
+            chain_time, standard_time, (glm::u64) sizeof(ChainAllocator<int>));
+
+        return passed;
+    }
+
+    bool testMemoryPoolRegistry(Context* context)
+    {
+        glm::u32 handle = SharedPtr<HeapMemoryPool>(new HeapMemoryPool())->getHandle();
+        SharedPtr<HeapMemoryPool> reused(new HeapMemoryPool());
+
+        // The slot comes back with a new generation
+        bool passed = (reused->getHandle() & 0xFFFF) == (handle & 0xFFFF) && reused->getHandle() != handle;
+
+        std::vector<SharedPtr<HeapMemoryPool>> pools;
+        while (pools.size() <= MEMORY_POOL_MAX && (pools.empty() || pools.back()->getHandle() != MEMORY_POOL_INVALID))
+            pools.push_back(SharedPtr<HeapMemoryPool>(new HeapMemoryPool()));
+
+        Log::rawf("	Registry full after %llu pools", (glm::u64) pools.size());
+        passed = passed && pools.back()->getHandle() == MEMORY_POOL_INVALID;
+
+        pools.clear();
+        SharedPtr<HeapMemoryPool> after(new HeapMemoryPool());
+
+        return passed && after->getHandle() != MEMORY_POOL_INVALID && MemoryPoolRegistry::getPool(after->getHandle()) == after.get();
+    }
+}
\ No newline at end of file
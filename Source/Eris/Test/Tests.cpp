@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tests.h"
+
+#include "Core/Log.h"
+#include "Engine/Engine.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Eris
+{
+    static const TestCase TESTS[] =
+    {
+        { "StringHash", &testStringHash },
+        { "EventDispatch", &testEventDispatch },
+        { "ChainMemoryPool", &testChainMemoryPool },
+        { "ChainAllocator", &testChainAllocator },
+        { "MemoryPoolRegistry", &testMemoryPoolRegistry },
+        { "SharedPtr", &testSharedPtr },
+        { "TlsfMemoryPool", &testTlsfMemoryPool },
+        { "JobSystem", &testJobSystem },
+        { "MpmcQueue", &testMpmcQueue },
+        { "SpscQueue", &testSpscQueue },
+        { "MpscQueue", &testMpscQueue }
+    };
+
+    static const std::chrono::high_resolution_clock::time_point s_start_time = std::chrono::high_resolution_clock::now();
+
+    int runTests(Context* context, const std::string& filter)
+    {
+        Log* log = new Log(context);
+        context->registerModule(log);
+        log->open("tests.log");
+        log->setTimestamp(false);
+
+        glm::u32 failed = 0;
+        glm::u32 count = 0;
+
+        for (const TestCase& test : TESTS)
+        {
+            if (std::string{ test.name }.compare(0, filter.size(), filter) != 0)
+                continue;
+
+            Log::rawf("%s", test.name);
+
+            glm::f64 start = getTestTime();
+            bool passed = test.run(context);
+            glm::f64 duration = getTestTime() - start;
+
+            Log::rawf("\t%s in %.3f s", passed ? "Passed" : "FAILED", duration);
+
+            if (!passed)
+                failed++;
+            count++;
+        }
+
+        Log::rawf("%u of %u tests passed", count - failed, count);
+
+        return failed ? EXIT_TEST_FAILURE : EXIT_OK;
+    }
+
+    glm::f64 getTestTime()
+    {
+        // Relative to startup, seconds since the epoch would leave a double sub-microsecond steps.
+        return std::chrono::duration<glm::f64>(std::chrono::high_resolution_clock::now() - s_start_time).count();
+    }
+
+    void logPercentiles(const std::string& name, std::vector<glm::f64>& samples)
+    {
+        if (samples.empty())
+            return;
+
+        std::sort(samples.begin(), samples.end());
+
+        std::size_t last = samples.size() - 1;
+        Log::rawf("\t%s: min %.0f ns, p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns, max %.0f ns", name.c_str(),
+            samples[0] * 1e9, samples[last / 2] * 1e9, samples[last * 99 / 100] * 1e9, samples[last * 999 / 1000] * 1e9,
+            samples[last] * 1e9);
+    }
+}
\ No newline at end of file
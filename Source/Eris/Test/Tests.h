@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Eris
+{
+    class Context;
+
+    /// A randomized stress test or benchmark, failing when it catches a broken invariant.
+    using TestFunction = bool(*)(Context* context);
+
+    struct TestCase
+    {
+        const char* name;
+        TestFunction run;
+    };
+
+    /// Runs every test whose name starts with filter and logs the results to tests.log. Returns an engine exit code.
+    int runTests(Context* context, const std::string& filter);
+
+    /// Seconds on a high resolution clock, Timer only ticks once glfw is up.
+    glm::f64 getTestTime();
+
+    /// Logs the min, median, 99th, 99.9th percentile and max of samples in nanoseconds. Sorts the samples.
+    void logPercentiles(const std::string& name, std::vector<glm::f64>& samples);
+
+    bool testStringHash(Context* context);
+    bool testEventDispatch(Context* context);
+    bool testChainMemoryPool(Context* context);
+    bool testChainAllocator(Context* context);
+    bool testMemoryPoolRegistry(Context* context);
+    bool testSharedPtr(Context* context);
+    bool testTlsfMemoryPool(Context* context);
+    bool testJobSystem(Context* context);
+    bool testMpmcQueue(Context* context);
+    bool testSpscQueue(Context* context);
+    bool testMpscQueue(Context* context);
+}
\ No newline at end of file
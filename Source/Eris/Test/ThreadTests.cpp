@@ -0,0 +1,385 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Tests.h"
+
+#include "Core/Log.h"
+#include "Memory/Pointers.h"
+#include "Thread/EventCount.h"
+#include "Thread/JobSystem.h"
+#include "Thread/MpmcQueue.h"
+#include "Thread/MpscQueue.h"
+#include "Thread/Semaphore.h"
+#include "Thread/SpscQueue.h"
+
+#include <atomic>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Eris
+{
+    static const glm::u32 TEST_JOBS = JOB_POOL_SIZE * 4;
+    static const glm::u32 TEST_PRODUCERS = 4;
+    static const glm::u32 TEST_CONSUMERS = 4;
+    static const glm::u32 TEST_ITEMS = 100000;
+
+    struct TestNode : MpscNode
+    {
+        glm::u64 value;
+    };
+
+    static std::atomic<glm::u32> s_first_done;
+    static std::atomic<bool> s_ran_early;
+
+    static void runFirstJob(void* data, glm::u32 begin, glm::u32 end)
+    {
+        (*static_cast<std::atomic<glm::u32>*>(data))++;
+        s_first_done++;
+    }
+
+    static void runSecondJob(void* data, glm::u32 begin, glm::u32 end)
+    {
+        if (s_first_done.load() != TEST_JOBS / 2)
+            s_ran_early = true;
+        (*static_cast<std::atomic<glm::u32>*>(data))++;
+    }
+
+    bool testJobSystem(Context* context)
+    {
+        SharedPtr<JobSystem> job_system(new JobSystem(context));
+        job_system->initialize(4);
+
+        std::vector<std::atomic<glm::u32>> runs(TEST_JOBS);
+        bool passed = true;
+
+        for (glm::u32 round = 0; round < 8 && passed; ++round)
+        {
+            for (auto& count : runs)
+                count = 0;
+            s_first_done = 0;
+            s_ran_early = false;
+
+            // Scheduling outruns the ring, the second half parks on the first while it is still running.
+            JobCounter first;
+            JobCounter second;
+            for (glm::u32 i = 0; i < TEST_JOBS / 2; ++i)
+                job_system->schedule(&runFirstJob, &runs[i], &first);
+            for (glm::u32 i = 0; i < TEST_JOBS / 2; ++i)
+                job_system->schedule(&runSecondJob, &runs[TEST_JOBS / 2 + i], &second, &first);
+            job_system->wait(&second);
+
+            // Every job ran exactly once, none of the dependent ones before the last of the first half
+            for (auto& count : runs)
+                passed = passed && count.load() == 1;
+            passed = passed && !s_ran_early.load() && first.isDone();
+        }
+
+        Log::rawf("\t%u jobs outstanding per round", TEST_JOBS);
+        job_system->terminate();
+
+        return passed;
+    }
+
+    bool testMpmcQueue(Context* context)
+    {
+        static MpmcQueue<glm::u64, 1024> queue;
+        std::atomic<glm::u64> sum(0);
+        std::atomic<glm::u32> popped(0);
+        std::vector<std::thread> threads;
+
+        // Producers stall at random so the queue swings between empty and full
+        glm::f64 begin = getTestTime();
+        for (glm::u32 p = 0; p < TEST_PRODUCERS; ++p)
+        {
+            threads.emplace_back([&, p]
+            {
+                std::mt19937 random(p);
+                for (glm::u32 i = 1; i <= TEST_ITEMS; ++i)
+                {
+                    while (!queue.push(glm::u64(p) * TEST_ITEMS + i))
+                        std::this_thread::yield();
+                    if (random() % 64 == 0)
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (glm::u32 c = 0; c < TEST_CONSUMERS; ++c)
+        {
+            threads.emplace_back([&]
+            {
+                glm::u64 value;
+                while (popped.load() < TEST_PRODUCERS * TEST_ITEMS)
+                {
+                    if (queue.pop(value))
+                    {
+                        sum += value;
+                        popped++;
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        glm::f64 queue_time = getTestTime() - begin;
+
+        glm::u64 expected = 0;
+        for (glm::u32 p = 0; p < TEST_PRODUCERS; ++p)
+            for (glm::u32 i = 1; i <= TEST_ITEMS; ++i)
+                expected += glm::u64(p) * TEST_ITEMS + i;
+        bool passed = sum.load() == expected;
+
+        // Same traffic through a locked std::queue for comparison
+        std::queue<glm::u64> locked_queue;
+        std::mutex mutex;
+        popped = 0;
+        threads.clear();
+        begin = getTestTime();
+        for (glm::u32 p = 0; p < TEST_PRODUCERS; ++p)
+        {
+            threads.emplace_back([&]
+            {
+                for (glm::u32 i = 1; i <= TEST_ITEMS; ++i)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    locked_queue.push(i);
+                }
+            });
+        }
+        for (glm::u32 c = 0; c < TEST_CONSUMERS; ++c)
+        {
+            threads.emplace_back([&]
+            {
+                while (popped.load() < TEST_PRODUCERS * TEST_ITEMS)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!locked_queue.empty())
+                    {
+                        locked_queue.pop();
+                        popped++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        glm::f64 locked_time = getTestTime() - begin;
+
+        Log::rawf("\tMpmcQueue %.1f ns/item, std::queue with std::mutex %.1f ns/item",
+            queue_time * 1e9 / (TEST_PRODUCERS * TEST_ITEMS), locked_time * 1e9 / (TEST_PRODUCERS * TEST_ITEMS));
+
+        // Consumers sleep on an event count whenever the queue runs dry, none of them may miss the last wake up
+        static MpmcQueue<glm::u32, 64> blocking_queue;
+        EventCount wake;
+        std::atomic<bool> done(false);
+        popped = 0;
+        threads.clear();
+        begin = getTestTime();
+        for (glm::u32 c = 0; c < TEST_CONSUMERS; ++c)
+        {
+            threads.emplace_back([&]
+            {
+                glm::u32 value;
+                for (;;)
+                {
+                    if (blocking_queue.pop(value))
+                    {
+                        popped++;
+                        continue;
+                    }
+
+                    EventCount::Key key = wake.prepareWait();
+                    if (blocking_queue.pop(value))
+                    {
+                        wake.cancelWait();
+                        popped++;
+                    }
+                    else if (done.load())
+                    {
+                        wake.cancelWait();
+                        return;
+                    }
+                    else
+                        wake.wait(key);
+                }
+            });
+        }
+        std::vector<std::thread> producers;
+        for (glm::u32 p = 0; p < TEST_PRODUCERS; ++p)
+        {
+            producers.emplace_back([&]
+            {
+                for (glm::u32 i = 0; i < TEST_ITEMS / 10; ++i)
+                {
+                    while (!blocking_queue.push(i))
+                        std::this_thread::yield();
+                    wake.notify();
+                    if (i % 1000 == 0)
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            });
+        }
+        for (auto& thread : producers)
+            thread.join();
+        while (popped.load() < TEST_PRODUCERS * (TEST_ITEMS / 10))
+            std::this_thread::yield();
+        done = true;
+        wake.notify();
+        for (auto& thread : threads)
+            thread.join();
+
+        Log::rawf("\tMpmcQueue with EventCount %.1f ms for %u items", (getTestTime() - begin) * 1e3, TEST_PRODUCERS * (TEST_ITEMS / 10));
+
+        return passed && popped.load() == TEST_PRODUCERS * (TEST_ITEMS / 10);
+    }
+
+    bool testSpscQueue(Context* context)
+    {
+        static SpscQueue<glm::u32, 256> queue;
+        glm::u32 count = TEST_PRODUCERS * TEST_ITEMS;
+        bool ordered = true;
+
+        // Both sides stall at random so the ring keeps crossing full and empty, values must come out in push order
+        glm::f64 begin = getTestTime();
+        std::thread producer([&]
+        {
+            std::mt19937 random(1);
+            for (glm::u32 i = 0; i < count; ++i)
+            {
+                while (!queue.push(i))
+                    std::this_thread::yield();
+                if (random() % 256 == 0)
+                    std::this_thread::yield();
+            }
+        });
+        std::thread consumer([&]
+        {
+            std::mt19937 random(2);
+            glm::u32 value;
+            for (glm::u32 expected = 0; expected < count;)
+            {
+                if (!queue.pop(value))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                ordered = ordered && value == expected;
+                ++expected;
+                if (random() % 256 == 0)
+                    std::this_thread::yield();
+            }
+        });
+        producer.join();
+        consumer.join();
+        glm::f64 queue_time = getTestTime() - begin;
+
+        // Same traffic through a locked std::queue for comparison
+        std::queue<glm::u32> locked_queue;
+        std::mutex mutex;
+        begin = getTestTime();
+        producer = std::thread([&]
+        {
+            for (glm::u32 i = 0; i < count; ++i)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked_queue.push(i);
+            }
+        });
+        consumer = std::thread([&]
+        {
+            for (glm::u32 popped = 0; popped < count;)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!locked_queue.empty())
+                {
+                    locked_queue.pop();
+                    ++popped;
+                }
+            }
+        });
+        producer.join();
+        consumer.join();
+        glm::f64 locked_time = getTestTime() - begin;
+
+        Log::rawf("\tSpscQueue %.1f ns/item, std::queue with std::mutex %.1f ns/item", queue_time * 1e9 / count, locked_time * 1e9 / count);
+
+        return ordered;
+    }
+
+    bool testMpscQueue(Context* context)
+    {
+        static MpscQueue<TestNode> queue;
+        Semaphore count;
+        std::vector<TestNode> nodes(TEST_PRODUCERS * TEST_ITEMS);
+        glm::u64 sum = 0;
+        bool ordered = true;
+
+        // The consumer blocks on the semaphore, every producer's nodes have to come out in push order
+        glm::f64 begin = getTestTime();
+        std::thread consumer([&]
+        {
+            std::vector<glm::u64> last(TEST_PRODUCERS, 0);
+            for (glm::u32 i = 0; i < TEST_PRODUCERS * TEST_ITEMS; ++i)
+            {
+                count.wait();
+                TestNode* node;
+                while (!(node = queue.pop()))
+                    std::this_thread::yield();
+
+                glm::u32 producer = static_cast<glm::u32>(node->value / (TEST_ITEMS + 1));
+                glm::u64 index = node->value % (TEST_ITEMS + 1);
+                ordered = ordered && index > last[producer];
+                last[producer] = index;
+                sum += index;
+            }
+        });
+        std::vector<std::thread> producers;
+        for (glm::u32 p = 0; p < TEST_PRODUCERS; ++p)
+        {
+            producers.emplace_back([&, p]
+            {
+                std::mt19937 random(p);
+                for (glm::u32 i = 1; i <= TEST_ITEMS; ++i)
+                {
+                    TestNode& node = nodes[p * TEST_ITEMS + i - 1];
+                    node.value = glm::u64(p) * (TEST_ITEMS + 1) + i;
+                    queue.push(&node);
+                    count.signal();
+                    if (random() % 64 == 0)
+                        std::this_thread::yield();
+                }
+            });
+        }
+        for (auto& thread : producers)
+            thread.join();
+        consumer.join();
+
+        Log::rawf("\tMpscQueue with Semaphore %.1f ns/item", (getTestTime() - begin) * 1e9 / (TEST_PRODUCERS * TEST_ITEMS));
+
+        return ordered && sum == glm::u64(TEST_PRODUCERS) * TEST_ITEMS * (TEST_ITEMS + 1) / 2;
+    }
+}
\ No newline at end of file
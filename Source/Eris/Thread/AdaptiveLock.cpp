@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "AdaptiveLock.h"
+#include "Functions.h"
+#include "ParkingLot.h"
+
+namespace Eris
+{
+    AdaptiveLock::AdaptiveLock() :
+        m_state(0)
+    {
+    }
+
+    void AdaptiveLock::lock()
+    {
+        glm::u32 expected = 0;
+        if (!m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+            lockContended();
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+    }
+
+    bool AdaptiveLock::try_lock()
+    {
+        glm::u32 expected = 0;
+        if (!m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return false;
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+        return true;
+    }
+
+    void AdaptiveLock::unlock()
+    {
+        if (m_state.exchange(0, std::memory_order_release) == 2)
+            ParkingLot::unpark(&m_state);
+    }
+
+    void AdaptiveLock::setName(const char* name)
+    {
+#ifdef ERIS_LOCK_STATS
+        m_counters.setName(name);
+#else
+        (void) name;
+#endif
+    }
+
+    void AdaptiveLock::lockContended()
+    {
+#ifdef ERIS_LOCK_STATS
+        glm::u64 start = LockCounters::getTime();
+#endif
+        glm::u32 backoff = 1;
+        glm::u32 spins = 0;
+        bool parked = false;
+
+        for (; spins < LOCK_SPIN_COUNT; spins++)
+        {
+            cpuPause(backoff);
+            if (backoff < LOCK_BACKOFF_MAX)
+                backoff <<= 1;
+
+            glm::u32 expected = 0;
+            if (m_state.load(std::memory_order_relaxed) == 0 &&
+                m_state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+                break;
+        }
+
+        if (spins == LOCK_SPIN_COUNT)
+        {
+            // Marking the lock as having waiters makes the holder wake us, we cannot know if others are parked so
+            // the lock stays marked once we own it.
+            while (m_state.exchange(2, std::memory_order_acquire) != 0)
+            {
+                parked = true;
+                ParkingLot::park(&m_state, [this] { return m_state.load() == 2; });
+            }
+        }
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordContention(spins, parked, LockCounters::getTime() - start);
+#else
+        (void) parked;
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "LockStats.h"
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    /// Spins with exponential backoff for a short while, then parks the thread until the holder unlocks.
+    class AdaptiveLock : public NonCopyable
+    {
+    public:
+        AdaptiveLock();
+
+        void lock();
+        bool try_lock();
+        void unlock();
+
+        void setName(const char* name);
+
+    private:
+        void lockContended();
+
+        /// 0 when free, 1 when locked, 2 when locked and a thread may be parked on it.
+        std::atomic<glm::u32> m_state;
+#ifdef ERIS_LOCK_STATS
+        LockCounters m_counters;
+#endif
+    };
+}
\ No newline at end of file
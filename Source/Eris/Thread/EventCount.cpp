@@ -0,0 +1,57 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "EventCount.h"
+#include "ParkingLot.h"
+
+namespace Eris
+{
+    EventCount::EventCount() :
+        m_epoch(0),
+        m_waiters(0)
+    {
+    }
+
+    EventCount::Key EventCount::prepareWait()
+    {
+        m_waiters++;
+        return m_epoch.load();
+    }
+
+    void EventCount::cancelWait()
+    {
+        m_waiters--;
+    }
+
+    void EventCount::wait(Key key)
+    {
+        ParkingLot::park(&m_epoch, [this, key] { return m_epoch.load() == key; });
+        m_waiters--;
+    }
+
+    void EventCount::notify()
+    {
+        m_epoch++;
+        if (m_waiters.load())
+            ParkingLot::unpark(&m_epoch);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Functions.h"
+
+#include <algorithm>
+
+namespace Eris
+{
+    ERIS_THREAD_LOCAL glm::u32 t_thread_index = 0;
+
+    // Only constant initialised state, indices are handed out during static initialisation too.
+    static std::atomic_flag s_lock = ATOMIC_FLAG_INIT;
+    static glm::u32 s_used[THREAD_INDEX_MAX / 32] = { 0 };
+    static ThreadExitCallback s_callbacks[THREAD_EXIT_CALLBACKS_MAX] = { nullptr };
+    static glm::u32 s_callback_count = 0;
+    static DWORD s_exit_slot = FLS_OUT_OF_INDEXES;
+
+    static void WINAPI releaseThreadIndex(void* data)
+    {
+        glm::u32 index = static_cast<glm::u32>(reinterpret_cast<std::size_t>(data)) - 1;
+
+        while (s_lock.test_and_set(std::memory_order_acquire));
+        ThreadExitCallback callbacks[THREAD_EXIT_CALLBACKS_MAX];
+        glm::u32 count = s_callback_count;
+        std::copy(s_callbacks, s_callbacks + count, callbacks);
+        s_lock.clear(std::memory_order_release);
+
+        for (glm::u32 i = 0; i < count; i++)
+            callbacks[i](index);
+
+        // Anything the thread still allocates on its way out must not use the slots of the next owner.
+        t_thread_index = THREAD_INDEX_MAX + 1;
+
+        while (s_lock.test_and_set(std::memory_order_acquire));
+        s_used[index / 32] &= ~(1U << (index % 32));
+        s_lock.clear(std::memory_order_release);
+    }
+
+    glm::u32 acquireThreadIndex()
+    {
+        glm::u32 index = THREAD_INDEX_MAX;
+
+        while (s_lock.test_and_set(std::memory_order_acquire));
+
+        // The fiber local slot only exists for its destructor, which runs on the exiting thread.
+        if (s_exit_slot == FLS_OUT_OF_INDEXES)
+            s_exit_slot = FlsAlloc(&releaseThreadIndex);
+
+        for (glm::u32 i = 0; i < THREAD_INDEX_MAX / 32 && index == THREAD_INDEX_MAX; i++)
+        {
+            if (s_used[i] != 0xFFFFFFFF)
+            {
+                glm::u32 bit = 0;
+                while (s_used[i] & (1U << bit))
+                    bit++;
+
+                s_used[i] |= 1U << bit;
+                index = i * 32 + bit;
+            }
+        }
+
+        DWORD exit_slot = s_exit_slot;
+        s_lock.clear(std::memory_order_release);
+
+        if (index < THREAD_INDEX_MAX && exit_slot != FLS_OUT_OF_INDEXES)
+            FlsSetValue(exit_slot, reinterpret_cast<void*>(static_cast<std::size_t>(index) + 1));
+
+        return index;
+    }
+
+    void addThreadExitCallback(ThreadExitCallback callback)
+    {
+        while (s_lock.test_and_set(std::memory_order_acquire));
+
+        ERIS_ASSERT(s_callback_count < THREAD_EXIT_CALLBACKS_MAX);
+        if (s_callback_count < THREAD_EXIT_CALLBACKS_MAX)
+            s_callbacks[s_callback_count++] = callback;
+
+        s_lock.clear(std::memory_order_release);
+    }
+}
\ No newline at end of file
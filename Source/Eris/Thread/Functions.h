@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include <atomic>
+#include <intrin.h>
+
+namespace Eris
+{
+    /// Threads that can hold an index at the same time.
+    static const glm::u32 THREAD_INDEX_MAX = 256;
+    static const glm::u32 THREAD_EXIT_CALLBACKS_MAX = 8;
+
+    using ThreadExitCallback = void(*)(glm::u32 thread_index);
+
+    /// One past the index of the calling thread, zero until it asked for one.
+    extern ERIS_THREAD_LOCAL glm::u32 t_thread_index;
+
+    glm::u32 acquireThreadIndex();
+
+    /// Small dense index of the calling thread. It is handed out again once the thread exits, so anything kept per
+    /// index must be given back from a thread exit callback. Threads past THREAD_INDEX_MAX, and threads that already
+    /// ran their exit callbacks, get THREAD_INDEX_MAX.
+    inline glm::u32 getThreadIndex()
+    {
+        if (!t_thread_index)
+            t_thread_index = acquireThreadIndex() + 1;
+
+        return t_thread_index - 1;
+    }
+
+    /// Called on the exiting thread, before its index is reused. Callbacks can not be removed.
+    void addThreadExitCallback(ThreadExitCallback callback);
+
+    /// Tells the core it is in a spin wait, so it saves power and leaves the pipeline to the other hyperthread.
+    inline void cpuPause(glm::u32 count)
+    {
+        for (glm::u32 i = 0; i < count; i++)
+            _mm_pause();
+    }
+}
\ No newline at end of file
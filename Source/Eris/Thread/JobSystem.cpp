@@ -0,0 +1,344 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "JobSystem.h"
+
+#include "Core/Log.h"
+#include "Core/Profiler.h"
+
+#include <algorithm>
+
+namespace Eris
+{
+    struct JobWorker
+    {
+        JobWorker(glm::u32 index) :
+            index(index),
+            next_job(0),
+            random(index * 2654435761u + 1)
+        {
+            for (Job& job : jobs)
+                job.busy = false;
+        }
+
+        WorkStealingDeque<Job, JOB_QUEUE_SIZE> queue;
+        /// Ring of jobs scheduled by this worker, slots are reused once their job has run.
+        Job jobs[JOB_POOL_SIZE];
+        glm::u32 index;
+        glm::u32 next_job;
+        glm::u32 random;
+        std::thread thread;
+    };
+
+    static ERIS_THREAD_LOCAL JobWorker* t_worker = nullptr;
+
+    JobSystem::JobSystem(Context* context) :
+        Object(context),
+        m_pending(0),
+        m_exiting(false)
+    {
+    }
+
+    JobSystem::~JobSystem()
+    {
+        terminate();
+    }
+
+    void JobSystem::initialize(glm::u32 workers /*= 0*/)
+    {
+        if (!m_workers.empty())
+            return;
+
+        if (!workers)
+            workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_exiting = false;
+        for (glm::u32 i = 0; i < workers; i++)
+            m_workers.push_back(new JobWorker(i));
+
+        t_worker = m_workers[0];
+        for (glm::u32 i = 1; i < workers; i++)
+            m_workers[i]->thread = std::thread(&JobSystem::run, this, m_workers[i]);
+
+        Log::infof("Job system started with %u workers", workers);
+    }
+
+    void JobSystem::terminate()
+    {
+        if (m_workers.empty())
+            return;
+
+        m_exiting = true;
+        m_wake.notify();
+
+        for (auto worker : m_workers)
+        {
+            if (worker->thread.joinable())
+                worker->thread.join();
+        }
+
+        if (t_worker == m_workers[0])
+            t_worker = nullptr;
+
+        for (auto worker : m_workers)
+            delete worker;
+        m_workers.clear();
+        m_pending = 0;
+    }
+
+    void JobSystem::schedule(JobFunction function, void* data, JobCounter* counter /*= nullptr*/, JobCounter* dependency /*= nullptr*/)
+    {
+        ERIS_ASSERT(function);
+
+        JobWorker* worker = t_worker;
+        if (!worker)
+        {
+            wait(dependency);
+            function(data, 0, 1);
+            return;
+        }
+
+        if (counter)
+            counter->m_value++;
+
+        Job* job = allocateJob(worker);
+        job->function = function;
+        job->data = data;
+        job->begin = 0;
+        job->end = 1;
+        job->counter = counter;
+        submit(job, dependency);
+    }
+
+    void JobSystem::scheduleRange(JobFunction function, void* data, glm::u32 count, glm::u32 grain, JobCounter* counter, JobCounter* dependency /*= nullptr*/)
+    {
+        ERIS_ASSERT(function);
+
+        if (!count)
+            return;
+
+        JobWorker* worker = t_worker;
+        if (!worker)
+        {
+            wait(dependency);
+            function(data, 0, count);
+            return;
+        }
+
+        if (!grain)
+            grain = std::max(count / (getWorkerCount() * 4), 1u);
+
+        if (counter)
+            counter->m_value += (count + grain - 1) / grain;
+
+        for (glm::u32 begin = 0; begin < count; begin += grain)
+        {
+            Job* job = allocateJob(worker);
+            job->function = function;
+            job->data = data;
+            job->begin = begin;
+            job->end = std::min(begin + grain, count);
+            job->counter = counter;
+            submit(job, dependency);
+        }
+    }
+
+    void JobSystem::wait(JobCounter* counter)
+    {
+        if (!counter)
+            return;
+
+        JobWorker* worker = t_worker;
+        while (!counter->isDone())
+        {
+            Job* job = findJob(worker);
+            if (job)
+                execute(job);
+            else
+                std::this_thread::yield();
+        }
+
+        // The last job may still hold the lock after releasing the counter, it must be done before the caller
+        // is allowed to destroy the counter.
+        counter->m_lock.lock();
+        counter->m_lock.unlock();
+    }
+
+    glm::u32 JobSystem::getWorkerIndex()
+    {
+        JobWorker* worker = t_worker;
+        return worker ? worker->index : JOB_WORKER_INVALID;
+    }
+
+    void JobSystem::run(JobWorker* worker)
+    {
+        t_worker = worker;
+        Log::infof("Job worker %u started", worker->index);
+        Profiler::setThreadName(("Job worker " + std::to_string(worker->index)).c_str());
+
+        glm::u32 idle = 0;
+        while (!m_exiting)
+        {
+            Job* job = findJob(worker);
+            if (job)
+            {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < JOB_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            idle = 0;
+            EventCount::Key key = m_wake.prepareWait();
+            if (m_pending.load() > 0 || m_exiting.load())
+                m_wake.cancelWait();
+            else
+                m_wake.wait(key);
+        }
+
+        Log::infof("Job worker %u stopped", worker->index);
+        t_worker = nullptr;
+    }
+
+    Job* JobSystem::allocateJob(JobWorker* worker)
+    {
+        // Only the owner allocates from its ring, other threads just release slots.
+        for (;;)
+        {
+            for (glm::u32 i = 0; i < JOB_POOL_SIZE; i++)
+            {
+                Job* job = &worker->jobs[worker->next_job++ & (JOB_POOL_SIZE - 1)];
+                if (!job->busy.load(std::memory_order_acquire))
+                {
+                    job->busy.store(true, std::memory_order_relaxed);
+                    return job;
+                }
+            }
+
+            // Every slot is outstanding, help run jobs until one is released.
+            Job* job = findJob(worker);
+            if (job)
+                execute(job);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::submit(Job* job, JobCounter* dependency)
+    {
+        if (dependency && !dependency->isDone())
+        {
+            dependency->m_lock.lock();
+            if (!dependency->isDone())
+            {
+                job->next = dependency->m_waiting;
+                dependency->m_waiting = job;
+                dependency->m_lock.unlock();
+                return;
+            }
+            dependency->m_lock.unlock();
+        }
+
+        push(job);
+    }
+
+    void JobSystem::push(Job* job)
+    {
+        // Counted first so a worker going to sleep either sees the job or gets woken up.
+        m_pending++;
+
+        JobWorker* worker = t_worker;
+        if (!worker || !worker->queue.push(job))
+        {
+            m_pending--;
+            execute(job);
+            return;
+        }
+
+        m_wake.notify();
+    }
+
+    Job* JobSystem::findJob(JobWorker* worker)
+    {
+        Job* job = worker ? worker->queue.pop() : nullptr;
+        if (!job)
+        {
+            glm::u32 count = getWorkerCount();
+            glm::u32 start = 0;
+            if (worker)
+            {
+                // Xorshift, so idle workers do not all hit the same victim.
+                worker->random ^= worker->random << 13;
+                worker->random ^= worker->random >> 17;
+                worker->random ^= worker->random << 5;
+                start = worker->random;
+            }
+
+            for (glm::u32 i = 0; i < count && !job; i++)
+            {
+                JobWorker* victim = m_workers[(start + i) % count];
+                if (victim != worker)
+                    job = victim->queue.steal();
+            }
+        }
+
+        if (job)
+            m_pending--;
+
+        return job;
+    }
+
+    void JobSystem::execute(Job* job)
+    {
+        JobCounter* counter = job->counter;
+        job->function(job->data, job->begin, job->end);
+        job->busy.store(false, std::memory_order_release);
+        finish(counter);
+    }
+
+    void JobSystem::finish(JobCounter* counter)
+    {
+        if (!counter)
+            return;
+
+        Job* waiting = nullptr;
+        counter->m_lock.lock();
+        if (--counter->m_value == 0)
+        {
+            waiting = counter->m_waiting;
+            counter->m_waiting = nullptr;
+        }
+        counter->m_lock.unlock();
+
+        while (waiting)
+        {
+            Job* next = waiting->next;
+            push(waiting);
+            waiting = next;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "EventCount.h"
+#include "SpinLock.h"
+#include "Types.h"
+#include "WorkStealingDeque.h"
+
+#include "Core/Context.h"
+#include "Core/Object.h"
+#include "Util/NonCopyable.h"
+
+#include <vector>
+
+namespace Eris
+{
+    class JobCounter;
+    struct JobWorker;
+
+    static const glm::u32 JOB_QUEUE_SIZE = 4096;
+    static const glm::u32 JOB_POOL_SIZE = 4096;
+    static const glm::u32 JOB_SPIN_COUNT = 64;
+    static const glm::u32 JOB_WORKER_INVALID = 0xFFFFFFFF;
+
+    /// Runs over [begin, end), single jobs get the range [0, 1).
+    using JobFunction = void(*)(void* data, glm::u32 begin, glm::u32 end);
+
+    struct Job
+    {
+        JobFunction function;
+        void* data;
+        glm::u32 begin;
+        glm::u32 end;
+        JobCounter* counter;
+        Job* next;
+        /// Set while the slot holds a job that has not run yet, queued, stolen or waiting on a dependency.
+        std::atomic<bool> busy;
+    };
+
+    /// Counts the unfinished jobs scheduled with it. Jobs depending on the counter are held back until it reaches zero.
+    class JobCounter : public NonCopyable
+    {
+        friend class JobSystem;
+
+    public:
+        JobCounter() :
+            m_value(0),
+            m_waiting(nullptr)
+        {
+        }
+
+        glm::u32 getValue() const { return m_value.load(); }
+        bool isDone() const { return m_value.load() == 0; }
+
+    private:
+        std::atomic<glm::u32> m_value;
+        SpinLock m_lock;
+        Job* m_waiting;
+    };
+
+    /// Work stealing scheduler, every worker owns a deque it pushes to and pops from while idle workers steal from
+    /// the others. The thread calling initialize becomes worker 0 and only runs jobs while it waits.
+    class JobSystem : public Object
+    {
+    public:
+        JobSystem(Context* context);
+        ~JobSystem();
+
+        /// A worker count of 0 uses one worker per hardware thread.
+        void initialize(glm::u32 workers = 0);
+        void terminate();
+
+        /// Jobs scheduled from a thread that is not a worker run immediately on that thread.
+        void schedule(JobFunction function, void* data, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+        /// Splits [0, count) into jobs of at most grain items, a grain of 0 picks one that keeps every worker busy.
+        void scheduleRange(JobFunction function, void* data, glm::u32 count, glm::u32 grain, JobCounter* counter, JobCounter* dependency = nullptr);
+        /// Runs other jobs until the counter reaches zero instead of blocking the thread.
+        void wait(JobCounter* counter);
+
+        template<typename T>
+        void parallelFor(glm::u32 count, const T& function, glm::u32 grain = 0)
+        {
+            JobCounter counter;
+            scheduleRange(&invokeRange<T>, const_cast<T*>(&function), count, grain, &counter);
+            wait(&counter);
+        }
+
+        glm::u32 getWorkerCount() const { return static_cast<glm::u32>(m_workers.size()); }
+
+        /// Worker the calling thread belongs to, JOB_WORKER_INVALID on threads outside the job system.
+        static glm::u32 getWorkerIndex();
+
+    private:
+        template<typename T>
+        static void invokeRange(void* data, glm::u32 begin, glm::u32 end)
+        {
+            (*static_cast<const T*>(data))(begin, end);
+        }
+
+        void run(JobWorker* worker);
+        Job* allocateJob(JobWorker* worker);
+        void submit(Job* job, JobCounter* dependency);
+        void push(Job* job);
+        Job* findJob(JobWorker* worker);
+        void execute(Job* job);
+        void finish(JobCounter* counter);
+
+        std::vector<JobWorker*> m_workers;
+        std::atomic<glm::i32> m_pending;
+        std::atomic<bool> m_exiting;
+        /// Idle workers sleep on it until a job is pushed or the system terminates.
+        EventCount m_wake;
+    };
+
+    template<> inline void Context::registerModule(JobSystem* module)
+    {
+        m_jobs = SharedPtr<JobSystem>(module);
+    }
+
+    template<> inline JobSystem* Context::getModule()
+    {
+        ERIS_ASSERT(m_jobs);
+        return m_jobs.get();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "LockStats.h"
+
+#include <chrono>
+
+namespace Eris
+{
+    std::atomic_flag LockRegistry::s_lock = ATOMIC_FLAG_INIT;
+    LockCounters* LockRegistry::s_counters[LOCK_STATS_MAX] = { nullptr };
+
+    LockCounters::LockCounters() :
+        m_name(nullptr),
+        m_acquisitions(0),
+        m_contentions(0),
+        m_spins(0),
+        m_parks(0),
+        m_wait_time(0)
+    {
+    }
+
+    LockCounters::~LockCounters()
+    {
+        if (m_name)
+            LockRegistry::remove(this);
+    }
+
+    void LockCounters::setName(const char* name)
+    {
+        if (!m_name && name)
+            LockRegistry::add(this);
+        else if (m_name && !name)
+            LockRegistry::remove(this);
+
+        m_name = name;
+    }
+
+    void LockCounters::recordContention(glm::u32 spins, bool parked, glm::u64 wait_nanoseconds)
+    {
+        add(m_contentions, 1);
+        add(m_spins, spins);
+        add(m_parks, parked ? 1 : 0);
+        add(m_wait_time, wait_nanoseconds);
+    }
+
+    LockStats LockCounters::getStats() const
+    {
+        LockStats stats;
+        stats.name = m_name ? m_name : "";
+        stats.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+        stats.contentions = m_contentions.load(std::memory_order_relaxed);
+        stats.spins = m_spins.load(std::memory_order_relaxed);
+        stats.parks = m_parks.load(std::memory_order_relaxed);
+        stats.wait_time = m_wait_time.load(std::memory_order_relaxed) / 1e9;
+        return stats;
+    }
+
+    glm::u64 LockCounters::getTime()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    void LockRegistry::add(LockCounters* counters)
+    {
+        while (s_lock.test_and_set(std::memory_order_acquire));
+
+        for (glm::u32 i = 0; i < LOCK_STATS_MAX; i++)
+        {
+            if (!s_counters[i])
+            {
+                s_counters[i] = counters;
+                break;
+            }
+        }
+
+        s_lock.clear(std::memory_order_release);
+    }
+
+    void LockRegistry::remove(LockCounters* counters)
+    {
+        while (s_lock.test_and_set(std::memory_order_acquire));
+
+        for (glm::u32 i = 0; i < LOCK_STATS_MAX; i++)
+        {
+            if (s_counters[i] == counters)
+            {
+                s_counters[i] = nullptr;
+                break;
+            }
+        }
+
+        s_lock.clear(std::memory_order_release);
+    }
+
+    std::vector<LockStats> LockRegistry::getStats()
+    {
+        std::vector<LockStats> out;
+
+        while (s_lock.test_and_set(std::memory_order_acquire));
+
+        for (glm::u32 i = 0; i < LOCK_STATS_MAX; i++)
+        {
+            if (!s_counters[i])
+                continue;
+
+            LockStats stats = s_counters[i]->getStats();
+
+            auto iter = out.begin();
+            for (; iter != out.end(); ++iter)
+            {
+                if (iter->name == stats.name)
+                    break;
+            }
+
+            if (iter == out.end())
+                out.push_back(stats);
+            else
+            {
+                iter->acquisitions += stats.acquisitions;
+                iter->contentions += stats.contentions;
+                iter->spins += stats.spins;
+                iter->parks += stats.parks;
+                iter->wait_time += stats.wait_time;
+            }
+        }
+
+        s_lock.clear(std::memory_order_release);
+
+        return out;
+    }
+}
\ No newline at end of file
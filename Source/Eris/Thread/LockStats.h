@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include <string>
+#include <vector>
+
+#ifdef _DEBUG
+#define ERIS_LOCK_STATS
+#endif
+
+namespace Eris
+{
+    static const glm::u32 LOCK_STATS_MAX = 1024;
+
+    struct LockStats
+    {
+        std::string name;
+        glm::u64 acquisitions;
+        glm::u64 contentions;
+        glm::u64 spins;
+        glm::u64 parks;
+        glm::f64 wait_time;
+    };
+
+    /// Contention counters of a lock. They are only written by the thread holding the lock, the atomics just make
+    /// reading them from another thread safe.
+    class LockCounters
+    {
+    public:
+        LockCounters();
+        ~LockCounters();
+
+        /// Named counters are reported by LockRegistry, the name must outlive the lock.
+        void setName(const char* name);
+        const char* getName() const { return m_name; }
+
+        void recordAcquisition() { add(m_acquisitions, 1); }
+        void recordContention(glm::u32 spins, bool parked, glm::u64 wait_nanoseconds);
+
+        LockStats getStats() const;
+
+        static glm::u64 getTime();
+
+    private:
+        static void add(std::atomic<glm::u64>& counter, glm::u64 value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        const char* m_name;
+        std::atomic<glm::u64> m_acquisitions;
+        std::atomic<glm::u64> m_contentions;
+        std::atomic<glm::u64> m_spins;
+        std::atomic<glm::u64> m_parks;
+        std::atomic<glm::u64> m_wait_time;
+    };
+
+    class LockRegistry
+    {
+    public:
+        static void add(LockCounters* counters);
+        static void remove(LockCounters* counters);
+
+        /// Counters of locks sharing a name are summed.
+        static std::vector<LockStats> getStats();
+
+    private:
+        static std::atomic_flag s_lock;
+        static LockCounters* s_counters[LOCK_STATS_MAX];
+    };
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    /// Bounded multiple producer, multiple consumer ring. Every cell carries a sequence number telling producers and
+    /// consumers whose turn it is, so neither side takes a lock and they only contend on their own index.
+    template<typename T, glm::u32 Capacity>
+    class MpmcQueue : public NonCopyable
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        MpmcQueue() :
+            m_enqueue(0),
+            m_dequeue(0)
+        {
+            for (glm::u32 i = 0; i < Capacity; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        /// Returns false when the queue is full.
+        bool push(const T& value)
+        {
+            Cell* cell;
+            glm::u32 position = m_enqueue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[position & (Capacity - 1)];
+                glm::i32 difference = static_cast<glm::i32>(cell->sequence.load(std::memory_order_acquire) - position);
+                if (difference == 0)
+                {
+                    if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = m_enqueue.load(std::memory_order_relaxed);
+            }
+
+            cell->value = value;
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Returns false when the queue is empty.
+        bool pop(T& value)
+        {
+            Cell* cell;
+            glm::u32 position = m_dequeue.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[position & (Capacity - 1)];
+                glm::i32 difference = static_cast<glm::i32>(cell->sequence.load(std::memory_order_acquire) - (position + 1));
+                if (difference == 0)
+                {
+                    if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = m_dequeue.load(std::memory_order_relaxed);
+            }
+
+            value = cell->value;
+            cell->sequence.store(position + Capacity, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<glm::u32> sequence;
+            T value;
+        };
+
+        std::atomic<glm::u32> m_enqueue;
+        glm::u8 m_enqueue_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::u32>)];
+        std::atomic<glm::u32> m_dequeue;
+        glm::u8 m_dequeue_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::u32>)];
+        Cell m_cells[Capacity];
+    };
+}
\ No newline at end of file
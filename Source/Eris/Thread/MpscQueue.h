@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    struct MpscNode
+    {
+        std::atomic<MpscNode*> next;
+    };
+
+    /// Intrusive multiple producer, single consumer queue. Pushing is wait free, nodes are owned by the caller and must outlive their time in the queue.
+    template<typename T>
+    class MpscQueue : public NonCopyable
+    {
+    public:
+        MpscQueue() :
+            m_head(&m_stub),
+            m_tail(&m_stub)
+        {
+            m_stub.next.store(nullptr, std::memory_order_relaxed);
+        }
+
+        void push(T* node)
+        {
+            pushNode(node);
+        }
+
+        /// Consumer only. Returns nullptr when empty or when a producer is part way through pushing the next node.
+        T* pop()
+        {
+            MpscNode* tail = m_tail;
+            MpscNode* next = tail->next.load(std::memory_order_acquire);
+
+            if (tail == &m_stub)
+            {
+                if (!next)
+                    return nullptr;
+
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                m_tail = next;
+                return static_cast<T*>(tail);
+            }
+
+            if (tail != m_head.load(std::memory_order_acquire))
+                return nullptr;
+
+            pushNode(&m_stub);
+
+            next = tail->next.load(std::memory_order_acquire);
+            if (next)
+            {
+                m_tail = next;
+                return static_cast<T*>(tail);
+            }
+
+            return nullptr;
+        }
+
+    private:
+        void pushNode(MpscNode* node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            MpscNode* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        std::atomic<MpscNode*> m_head;
+        MpscNode* m_tail;
+        MpscNode m_stub;
+    };
+}
\ No newline at end of file
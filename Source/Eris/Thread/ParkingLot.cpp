@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "ParkingLot.h"
+
+namespace Eris
+{
+    ParkingLot::Bucket ParkingLot::s_buckets[PARKING_LOT_BUCKETS];
+
+    void ParkingLot::unpark(const void* address)
+    {
+        Bucket& bucket = getBucket(address);
+
+        // Taking the lock orders the wake after any waiter that is between validating and sleeping.
+        std::lock_guard<std::mutex> lock(bucket.mutex);
+        bucket.conditional.notify_all();
+    }
+
+    ParkingLot::Bucket& ParkingLot::getBucket(const void* address)
+    {
+        std::size_t hash = reinterpret_cast<std::size_t>(address);
+        hash ^= hash >> 7;
+        hash ^= hash >> 13;
+        return s_buckets[hash % PARKING_LOT_BUCKETS];
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+namespace Eris
+{
+    static const glm::u32 PARKING_LOT_BUCKETS = 64;
+
+    /// Lets threads sleep on an address until another thread wakes it, the portable stand-in for a futex. Waiters
+    /// hash into a fixed set of buckets so parking never allocates.
+    class ParkingLot
+    {
+    public:
+        /// Sleeps while validate() holds, it is checked under the bucket lock so a wake after the state changed is never lost.
+        template<typename F>
+        static void park(const void* address, F validate)
+        {
+            Bucket& bucket = getBucket(address);
+
+            std::unique_lock<std::mutex> lock(bucket.mutex);
+            while (validate())
+                bucket.conditional.wait(lock);
+        }
+
+        /// Wakes every thread parked on the address, they check their own condition again.
+        static void unpark(const void* address);
+
+    private:
+        struct Bucket
+        {
+            std::mutex mutex;
+            std::condition_variable conditional;
+        };
+
+        static Bucket& getBucket(const void* address);
+
+        static Bucket s_buckets[PARKING_LOT_BUCKETS];
+    };
+}
\ No newline at end of file
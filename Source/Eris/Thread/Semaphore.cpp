@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Semaphore.h"
+#include "Functions.h"
+#include "ParkingLot.h"
+
+namespace Eris
+{
+    Semaphore::Semaphore(glm::i32 count /*= 0*/) :
+        m_count(count),
+        m_waiters(0)
+    {
+    }
+
+    void Semaphore::signal(glm::i32 count /*= 1*/)
+    {
+        m_count += count;
+        if (m_waiters.load())
+            ParkingLot::unpark(&m_count);
+    }
+
+    void Semaphore::wait()
+    {
+        glm::u32 backoff = 1;
+        for (glm::u32 spins = 0; spins < LOCK_SPIN_COUNT; spins++)
+        {
+            if (tryWait())
+                return;
+
+            cpuPause(backoff);
+            if (backoff < LOCK_BACKOFF_MAX)
+                backoff <<= 1;
+        }
+
+        while (!tryWait())
+        {
+            // Counted before the final check in park, so a signal either sees us or we see its permit.
+            m_waiters++;
+            ParkingLot::park(&m_count, [this] { return m_count.load() <= 0; });
+            m_waiters--;
+        }
+    }
+
+    bool Semaphore::tryWait()
+    {
+        glm::i32 count = m_count.load(std::memory_order_relaxed);
+        while (count > 0)
+        {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+}
\ No newline at end of file
@@ -21,21 +21,73 @@
 //
 
 #include "SpinLock.h"
+#include "Functions.h"
 
 namespace Eris
 {
-    SpinLock::SpinLock()
+    SpinLock::SpinLock() :
+        m_handle(false)
     {
-        m_handle.clear();
     }
 
     void SpinLock::lock()
     {
-        while (m_handle.test_and_set(std::memory_order_acquire));
+        if (m_handle.exchange(true, std::memory_order_acquire))
+            lockContended();
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+    }
+
+    bool SpinLock::try_lock()
+    {
+        if (m_handle.load(std::memory_order_relaxed) || m_handle.exchange(true, std::memory_order_acquire))
+            return false;
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+        return true;
     }
 
     void SpinLock::unlock()
     {
-        m_handle.clear(std::memory_order_release);
+        m_handle.store(false, std::memory_order_release);
+    }
+
+    void SpinLock::setName(const char* name)
+    {
+#ifdef ERIS_LOCK_STATS
+        m_counters.setName(name);
+#else
+        (void) name;
+#endif
+    }
+
+    void SpinLock::lockContended()
+    {
+#ifdef ERIS_LOCK_STATS
+        glm::u64 start = LockCounters::getTime();
+#endif
+        glm::u32 spins = 0;
+        glm::u32 backoff = 1;
+
+        // Only read while the lock is held so the waiters do not keep stealing the cache line from the holder.
+        do
+        {
+            if (backoff < LOCK_BACKOFF_MAX)
+            {
+                cpuPause(backoff);
+                backoff <<= 1;
+            }
+            else
+                std::this_thread::yield();
+            spins++;
+        } while (m_handle.load(std::memory_order_relaxed) || m_handle.exchange(true, std::memory_order_acquire));
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordContention(spins, false, LockCounters::getTime() - start);
+#endif
     }
 }
\ No newline at end of file
@@ -22,21 +22,33 @@
 
 #pragma once
 
+#include "LockStats.h"
+
 #include "Util/NonCopyable.h"
 
 #include <atomic>
 
 namespace Eris
 {
+    /// Never sleeps, contended threads back off and then yield. Only for sections a few instructions long, use
+    /// AdaptiveLock anywhere a holder may be preempted or do real work.
     class SpinLock : public NonCopyable
     {
     public:
         SpinLock();
 
         void lock();
+        bool try_lock();
         void unlock();
 
+        void setName(const char* name);
+
     private:  
-        std::atomic_flag m_handle;
+        void lockContended();
+
+        std::atomic<bool> m_handle;
+#ifdef ERIS_LOCK_STATS
+        LockCounters m_counters;
+#endif
     };
-}
+}
\ No newline at end of file
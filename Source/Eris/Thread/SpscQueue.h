@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    /// Bounded single producer, single consumer ring. Each side caches the other's index and only reloads it when
+    /// the ring looks full or empty, so in steady state neither touches the other's cache line.
+    template<typename T, glm::u32 Capacity>
+    class SpscQueue : public NonCopyable
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        SpscQueue() :
+            m_tail(0),
+            m_head_cache(0),
+            m_head(0),
+            m_tail_cache(0)
+        {
+        }
+
+        /// Producer only, returns false when the queue is full.
+        bool push(const T& value)
+        {
+            glm::u32 tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head_cache == Capacity)
+            {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+                if (tail - m_head_cache == Capacity)
+                    return false;
+            }
+
+            m_items[tail & (Capacity - 1)] = value;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Consumer only, returns false when the queue is empty.
+        bool pop(T& value)
+        {
+            glm::u32 head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail_cache)
+            {
+                m_tail_cache = m_tail.load(std::memory_order_acquire);
+                if (head == m_tail_cache)
+                    return false;
+            }
+
+            value = m_items[head & (Capacity - 1)];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::atomic<glm::u32> m_tail;
+        glm::u32 m_head_cache;
+        glm::u8 m_producer_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::u32>) - sizeof(glm::u32)];
+        std::atomic<glm::u32> m_head;
+        glm::u32 m_tail_cache;
+        glm::u8 m_consumer_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::u32>) - sizeof(glm::u32)];
+        T m_items[Capacity];
+    };
+}
\ No newline at end of file
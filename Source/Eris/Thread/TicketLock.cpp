@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "TicketLock.h"
+#include "Functions.h"
+#include "ParkingLot.h"
+
+#include <algorithm>
+
+namespace Eris
+{
+    TicketLock::TicketLock() :
+        m_next(0),
+        m_serving(0),
+        m_parked(0)
+    {
+    }
+
+    void TicketLock::lock()
+    {
+        glm::u32 ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (m_serving.load(std::memory_order_acquire) != ticket)
+            lockContended(ticket);
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+    }
+
+    bool TicketLock::try_lock()
+    {
+        glm::u32 serving = m_serving.load(std::memory_order_acquire);
+        glm::u32 expected = serving;
+        if (!m_next.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return false;
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordAcquisition();
+#endif
+        return true;
+    }
+
+    void TicketLock::unlock()
+    {
+        m_serving.fetch_add(1);
+        if (m_parked.load())
+            ParkingLot::unpark(&m_serving);
+    }
+
+    void TicketLock::setName(const char* name)
+    {
+#ifdef ERIS_LOCK_STATS
+        m_counters.setName(name);
+#else
+        (void) name;
+#endif
+    }
+
+    void TicketLock::lockContended(glm::u32 ticket)
+    {
+#ifdef ERIS_LOCK_STATS
+        glm::u64 start = LockCounters::getTime();
+#endif
+        glm::u32 spins = 0;
+        bool parked = false;
+
+        for (;;)
+        {
+            glm::u32 serving = m_serving.load(std::memory_order_acquire);
+            if (serving == ticket)
+                break;
+
+            if (spins < LOCK_SPIN_COUNT)
+            {
+                // Every holder ahead of us still has to run its section, wait roughly that long before looking again.
+                cpuPause(std::min((ticket - serving) * 8, LOCK_BACKOFF_MAX));
+                spins++;
+                continue;
+            }
+
+            // Counted before the final check in park, so unlock either sees us or we see its increment.
+            parked = true;
+            m_parked++;
+            ParkingLot::park(&m_serving, [this, ticket] { return m_serving.load() != ticket; });
+            m_parked--;
+        }
+
+#ifdef ERIS_LOCK_STATS
+        m_counters.recordContention(spins, parked, LockCounters::getTime() - start);
+#else
+        (void) parked;
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "LockStats.h"
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    /// Grants the lock in arrival order, so a thread that keeps relocking cannot starve the others. Waiters back off
+    /// in proportion to their place in line and park once they have spun for long enough.
+    class TicketLock : public NonCopyable
+    {
+    public:
+        TicketLock();
+
+        void lock();
+        bool try_lock();
+        void unlock();
+
+        void setName(const char* name);
+
+    private:
+        void lockContended(glm::u32 ticket);
+
+        std::atomic<glm::u32> m_next;
+        std::atomic<glm::u32> m_serving;
+        std::atomic<glm::u32> m_parked;
+#ifdef ERIS_LOCK_STATS
+        LockCounters m_counters;
+#endif
+    };
+}
\ No newline at end of file
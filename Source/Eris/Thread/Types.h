@@ -26,4 +26,20 @@
 #include <condition_variable>
 #include <future>
 #include <mutex>
-#include <thread>
\ No newline at end of file
+#include <thread>
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define ERIS_THREAD_LOCAL __declspec(thread)
+#else
+#define ERIS_THREAD_LOCAL thread_local
+#endif
+
+namespace Eris
+{
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Rounds a contended lock spins for before it gives up the core.
+    static const glm::u32 LOCK_SPIN_COUNT = 16;
+    /// Upper bound of the exponential backoff, in pause instructions.
+    static const glm::u32 LOCK_BACKOFF_MAX = 64;
+}
\ No newline at end of file
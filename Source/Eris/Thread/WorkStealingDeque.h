@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2013-2015 the Eris project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Types.h"
+
+#include "Util/NonCopyable.h"
+
+#include <atomic>
+
+namespace Eris
+{
+    /// Chase-Lev deque of pointers with a fixed power of two capacity. Only the owning thread may push and pop, any
+    /// thread may steal from the other end.
+    template<typename T, glm::u32 Capacity>
+    class WorkStealingDeque : public NonCopyable
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        WorkStealingDeque() :
+            m_top(0),
+            m_bottom(0)
+        {
+            for (glm::u32 i = 0; i < Capacity; i++)
+                m_items[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        /// Returns false when the deque is full.
+        bool push(T* item)
+        {
+            glm::i64 bottom = m_bottom.load(std::memory_order_relaxed);
+            glm::i64 top = m_top.load(std::memory_order_acquire);
+            if (bottom - top >= Capacity)
+                return false;
+
+            m_items[bottom & (Capacity - 1)].store(item, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        T* pop()
+        {
+            glm::i64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            glm::i64 top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = m_items[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last item, race the thieves for it.
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    item = nullptr;
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        T* steal()
+        {
+            glm::i64 top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            glm::i64 bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+                return nullptr;
+
+            T* item = m_items[top & (Capacity - 1)].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+            return item;
+        }
+
+        bool empty() const
+        {
+            return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        // Thieves and the owner write different ends, keep them on separate cache lines.
+        std::atomic<glm::i64> m_top;
+        glm::u8 m_top_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::i64>)];
+        std::atomic<glm::i64> m_bottom;
+        glm::u8 m_bottom_padding[CACHE_LINE_SIZE - sizeof(std::atomic<glm::i64>)];
+        std::atomic<T*> m_items[Capacity];
+    };
+}
\ No newline at end of file